@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "level.hpp"
+#include "collision/kernels.hpp"
+
+/**
+ * Narrow phase of collision of landers with level: four edges of each
+ * rectangle tested against each segment by line intersection as it was
+ * done before against batch separating axis kernel. Both get the same
+ * pairs of body and segment, which broad phase finds near surface.
+ * Bodies don't move, so both test the same rectangles, kernel does the
+ * same work for moving ones.
+ */
+
+namespace
+{
+    const GLfloat box_size = 40.f;
+
+    struct Bodies
+    {
+        std::vector<utils::RectPoints> rects;
+        BoxSegmentPairs pairs;
+        // Rectangle of each pair
+        std::vector<size_t> owners;
+    };
+
+    /**
+     * Place bodies of random angle near surface of generated level
+     * @param count
+     * @return
+     */
+    Bodies make_bodies(size_t count)
+    {
+        Level level;
+        level.height_min = 300.f;
+        level.height_max = 700.f;
+        level.seed = 1;
+
+        Terrain terrain;
+        for (std::ptrdiff_t i = 0; i < 4; ++i)
+            terrain.pushBack(level.generate(i));
+
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<GLfloat> x_dist(terrain.left(),
+                                                       terrain.right() - box_size);
+        std::uniform_real_distribution<GLfloat> alt_dist(-box_size, box_size);
+        std::uniform_real_distribution<GLfloat> angle_dist(0.f, glm::two_pi<GLfloat>());
+
+        Bodies bodies;
+        for (size_t i = 0; i < count; ++i) {
+            const GLfloat x = x_dist(gen);
+            const utils::Rect rect{x, terrain.height(x) - box_size + alt_dist(gen),
+                                   box_size, box_size};
+            const GLfloat angle = angle_dist(gen);
+            const coll::OrientedBox box = coll::buildOrientedBox(rect, angle);
+            const vec2 extent(box.half_w * std::fabs(box.axis.x)
+                              + box.half_h * std::fabs(box.axis.y),
+                              box.half_w * std::fabs(box.axis.y)
+                              + box.half_h * std::fabs(box.axis.x));
+
+            bodies.rects.push_back(coll::buildRectPoints(rect, angle));
+            terrain.forEachSegment(box.center - extent, box.center + extent,
+                                   [&bodies, &box, i](const vec2& p, const vec2& q,
+                                                      TerrainSegment) {
+                bodies.pairs.push_back(box, vec2(0.f, 0.f), p, q);
+                bodies.owners.push_back(i);
+            });
+        }
+
+        return bodies;
+    }
+}
+
+static void BM_CollisionLineLine(benchmark::State &state)
+{
+    const Bodies bodies = make_bodies(state.range(0));
+    const auto& pairs = bodies.pairs;
+    std::vector<char> collision(bodies.rects.size());
+
+    for (auto _: state) {
+        std::fill(collision.begin(), collision.end(), 0);
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            const utils::RectPoints& r = bodies.rects[bodies.owners[i]];
+            const vec2 p(pairs.px[i], pairs.py[i]);
+            const vec2 q(pairs.qx[i], pairs.qy[i]);
+            collision[bodies.owners[i]] |= coll::lineLine(r.d, r.a, p, q)
+                                           || coll::lineLine(r.b, r.c, p, q)
+                                           || coll::lineLine(r.c, r.d, p, q)
+                                           || coll::lineLine(r.a, r.b, p, q);
+        }
+        benchmark::DoNotOptimize(collision.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["pairs"] = pairs.size();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_CollisionSat(benchmark::State &state)
+{
+    const Bodies bodies = make_bodies(state.range(0));
+    const auto& pairs = bodies.pairs;
+    ContactArrays contacts;
+    contacts.resize(pairs.size());
+
+    for (auto _: state) {
+        coll::boxSegment(pairs, contacts, 0, pairs.size());
+        benchmark::DoNotOptimize(contacts.depth.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["pairs"] = pairs.size();
+    state.counters["simd_width"] = coll::simd_width;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_CollisionLineLine)->RangeMultiplier(10)->Range(1000, 100000)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CollisionSat)->RangeMultiplier(10)->Range(1000, 100000)
+        ->Unit(benchmark::kMicrosecond);
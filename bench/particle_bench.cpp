@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "particle/kernels.hpp"
+
+/**
+ * Integration of particles: array of structures updated by movement
+ * and gravity passes as it was done before against structure of
+ * arrays updated by fused SIMD kernel.
+ */
+
+namespace
+{
+    const GLfloat k = 1.f;
+    const GLfloat gravity = 0.5f / 150.f;
+}
+
+static void BM_ParticlesAoS(benchmark::State &state)
+{
+    std::vector<utils::Position> coords(state.range(0), {0.f, 0.f, 0.f});
+    std::vector<utils::Position> vel(state.range(0), {1.f, 1.f, 0.01f});
+
+    for (auto _: state) {
+        for (size_t i = 0; i < coords.size(); ++i) {
+            coords[i].x += vel[i].x * k;
+            coords[i].y += vel[i].y * k;
+            coords[i].angle += vel[i].angle * k;
+        }
+        for (size_t i = 0; i < vel.size(); ++i)
+            vel[i].y += gravity;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ParticlesSoA(benchmark::State &state)
+{
+    ParticleArrays coords;
+    ParticleArrays vel;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        coords.push_back({0.f, 0.f, 0.f});
+        vel.push_back({1.f, 1.f, 0.01f});
+    }
+
+    for (auto _: state) {
+        particle::integrate(coords, vel, k, gravity, 0, coords.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["simd_width"] = particle::simd_width;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ParticlesAoS)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ParticlesSoA)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
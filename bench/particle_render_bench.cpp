@@ -0,0 +1,183 @@
+#include <benchmark/benchmark.h>
+#include <GL/glew.h>
+#include <SDL.h>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "moonlanderprogram.hpp"
+#include "particleprogram.hpp"
+#include "render/render.hpp"
+#include "render/sprite.hpp"
+#include "utils/utils.hpp"
+
+/**
+ * Drawing of particles: draw call with model matrix update per particle
+ * as it was done before against one instanced call per pool.
+ * Context is created by Mesa software rasteriser (llvmpipe), so time
+ * doesn't depend on GPU and driver of machine. Each frame is finished
+ * by glFinish(), otherwise only recording of commands is measured.
+ * Without display run it under xvfb-run.
+ */
+
+namespace
+{
+    const int frame_width = 1920;
+    const int frame_height = 1080;
+    const GLfloat particle_scale = 1.5f;
+    // Ship sprite which is broken into debris
+    const utils::Rect ship_clip{0, 32, 20, 21};
+
+    class RenderContext
+    {
+    public:
+        RenderContext()
+        {
+            // Don't override user's choice of driver
+            setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+
+            if (SDL_Init(SDL_INIT_VIDEO) != 0)
+                throw std::runtime_error(SDL_GetError());
+
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
+                                SDL_GL_CONTEXT_PROFILE_CORE);
+            m_window = SDL_CreateWindow("particle_render_bench",
+                                        SDL_WINDOWPOS_UNDEFINED,
+                                        SDL_WINDOWPOS_UNDEFINED, 1, 1,
+                                        SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+            if (!m_window)
+                throw std::runtime_error(SDL_GetError());
+
+            m_context = SDL_GL_CreateContext(m_window);
+            if (!m_context)
+                throw std::runtime_error(SDL_GetError());
+
+            glewExperimental = GL_TRUE;
+            if (glewInit() != GLEW_OK)
+                throw std::runtime_error("Unable to initialize GLEW");
+
+            // Window is hidden, frames are drawn to texture of screen size
+            glGenTextures(1, &m_frame);
+            glBindTexture(GL_TEXTURE_2D, m_frame);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, frame_width, frame_height,
+                         0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glGenFramebuffers(1, &m_fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                   GL_TEXTURE_2D, m_frame, 0);
+            glViewport(0, 0, frame_width, frame_height);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            auto program = MoonLanderProgram::getInstance();
+            program->loadProgram();
+            program->setProjection(glm::ortho<GLfloat>(
+                    0.f, frame_width, frame_height, 0.f, 1.f, -1.f));
+            program->setModel(glm::mat4(1.f));
+            program->setView(glm::mat4(1.f));
+            program->updateModel();
+            program->updateView();
+            program->updateProjection();
+            ParticleProgram::getInstance()->loadProgram();
+
+            m_sprite = std::make_unique<Sprite>(
+                    utils::getResourcePath("lunar_lander_bw.png"));
+            for (const auto& clip: utils::generate_clips<4, 4>(ship_clip))
+                m_sprite->addClipSprite(clip);
+            m_sprite->generateDataBuffer();
+        }
+
+        ~RenderContext()
+        {
+            m_sprite.reset();
+            glDeleteFramebuffers(1, &m_fbo);
+            glDeleteTextures(1, &m_frame);
+            SDL_GL_DeleteContext(m_context);
+            SDL_DestroyWindow(m_window);
+            SDL_Quit();
+        }
+
+        Sprite& getSprite() noexcept
+        {
+            return *m_sprite;
+        }
+
+    private:
+        SDL_Window* m_window = nullptr;
+        SDL_GLContext m_context = nullptr;
+        GLuint m_fbo = 0;
+        GLuint m_frame = 0;
+        std::unique_ptr<Sprite> m_sprite;
+    };
+
+    RenderContext& context()
+    {
+        static RenderContext ctx;
+        return ctx;
+    }
+
+    ParticlePool make_pool(size_t count, GLuint clips)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<GLfloat> x(0.f, frame_width / particle_scale);
+        std::uniform_real_distribution<GLfloat> y(0.f, frame_height / particle_scale);
+        std::uniform_real_distribution<GLfloat> angle(0.f, 6.28f);
+        std::uniform_int_distribution<GLuint> clip(0, clips - 1);
+
+        ParticlePool pool(count, 1e6f);
+        for (size_t i = 0; i < count; ++i)
+            pool.spawn({x(gen), y(gen), angle(gen)}, {1.f, 1.f, 0.01f}, clip(gen));
+
+        return pool;
+    }
+}
+
+static void BM_ParticlesDrawTexture(benchmark::State &state)
+{
+    auto& sprite = context().getSprite();
+    auto program = MoonLanderProgram::getInstance();
+    const auto pool = make_pool(state.range(0), sprite.getSpritesCount());
+    const auto& coords = pool.getCoords();
+    const auto& clips = pool.getClips();
+
+    for (auto _: state) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        program->switchToTriangles();
+        program->setTextureRendering(true);
+        for (size_t i = 0; i < pool.size(); ++i) {
+            sprite.setIdx(clips[i]);
+            render::drawTexture(*program, sprite, coords.x[i], coords.y[i],
+                                coords.angle[i], particle_scale);
+        }
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ParticlesInstanced(benchmark::State &state)
+{
+    auto& sprite = context().getSprite();
+    auto program = ParticleProgram::getInstance();
+    const auto pool = make_pool(state.range(0), sprite.getSpritesCount());
+
+    for (auto _: state) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        program->bind();
+        program->draw(sprite, pool, 0.f, particle_scale);
+        program->unbind();
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ParticlesDrawTexture)->RangeMultiplier(4)->Range(256, 16384)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ParticlesInstanced)->RangeMultiplier(4)->Range(256, 16384)
+        ->Unit(benchmark::kMicrosecond);
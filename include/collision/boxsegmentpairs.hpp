@@ -0,0 +1,108 @@
+#ifndef MOONLANDER_BOXSEGMENTPAIRS_HPP
+#define MOONLANDER_BOXSEGMENTPAIRS_HPP
+
+#include <GL/glew.h>
+
+#include "utils/utils.hpp"
+#include "utils/alignedallocator.hpp"
+#include "utils/collision.hpp"
+
+/**
+ * Pairs of moving oriented box and segment to be tested for contact, stored
+ * as structure of arrays. Broad phase gathers them, so each pair is
+ * independent and kernel tests several pairs by one SIMD instruction
+ * (see collision/kernels.hpp).
+ */
+struct BoxSegmentPairs
+{
+    // Center at the beginning of step, unit vector along width
+    // and half sizes of box
+    utils::aligned_vector<GLfloat> cx;
+    utils::aligned_vector<GLfloat> cy;
+    utils::aligned_vector<GLfloat> ux;
+    utils::aligned_vector<GLfloat> uy;
+    utils::aligned_vector<GLfloat> half_w;
+    utils::aligned_vector<GLfloat> half_h;
+    // Motion of box during step
+    utils::aligned_vector<GLfloat> mx;
+    utils::aligned_vector<GLfloat> my;
+    // Ends of segment
+    utils::aligned_vector<GLfloat> px;
+    utils::aligned_vector<GLfloat> py;
+    utils::aligned_vector<GLfloat> qx;
+    utils::aligned_vector<GLfloat> qy;
+
+    size_t size() const noexcept
+    {
+        return cx.size();
+    }
+
+    /**
+     * @param box - box at the beginning of step
+     * @param motion - translation of box during step
+     * @param p
+     * @param q
+     */
+    void push_back(const coll::OrientedBox& box, const vec2& motion,
+                   const vec2& p, const vec2& q)
+    {
+        cx.push_back(box.center.x);
+        cy.push_back(box.center.y);
+        ux.push_back(box.axis.x);
+        uy.push_back(box.axis.y);
+        half_w.push_back(box.half_w);
+        half_h.push_back(box.half_h);
+        mx.push_back(motion.x);
+        my.push_back(motion.y);
+        px.push_back(p.x);
+        py.push_back(p.y);
+        qx.push_back(q.x);
+        qy.push_back(q.y);
+    }
+
+    void clear() noexcept
+    {
+        cx.clear();
+        cy.clear();
+        ux.clear();
+        uy.clear();
+        half_w.clear();
+        half_h.clear();
+        mx.clear();
+        my.clear();
+        px.clear();
+        py.clear();
+        qx.clear();
+        qy.clear();
+    }
+};
+
+/**
+ * Result of test of each pair: time of impact as fraction of step,
+ * which is infinite if box doesn't touch segment during step. Depth of
+ * penetration along axis of the least overlap and normal of contact
+ * which points from segment to box are taken at time of impact, so
+ * depth is zero unless box overlapped segment at the beginning of step.
+ */
+struct ContactArrays
+{
+    utils::aligned_vector<GLfloat> toi;
+    utils::aligned_vector<GLfloat> depth;
+    utils::aligned_vector<GLfloat> nx;
+    utils::aligned_vector<GLfloat> ny;
+
+    size_t size() const noexcept
+    {
+        return toi.size();
+    }
+
+    void resize(size_t size)
+    {
+        toi.resize(size);
+        depth.resize(size);
+        nx.resize(size);
+        ny.resize(size);
+    }
+};
+
+#endif //MOONLANDER_BOXSEGMENTPAIRS_HPP
@@ -0,0 +1,360 @@
+#ifndef MOONLANDER_COLLISION_KERNELS_HPP
+#define MOONLANDER_COLLISION_KERNELS_HPP
+
+#include <cmath>
+#include <limits>
+#include <GL/glew.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "collision/boxsegmentpairs.hpp"
+
+namespace coll
+{
+    /**
+     * Number of pairs tested by one instruction, instruction set
+     * is chosen as for particle kernels
+     */
+#if defined(__AVX__)
+    constexpr size_t simd_width = 8;
+#elif defined(__SSE2__)
+    constexpr size_t simd_width = 4;
+#else
+    constexpr size_t simd_width = 1;
+#endif
+
+    /**
+     * Test pairs in [begin, end) by separating axes: both axes of box
+     * and normal of segment. Box is swept by its motion, so it doesn't
+     * pass through segment however fast it moves. Projections of box
+     * and segment on axis overlap during interval of time, box touches
+     * segment when intervals of all axes overlap, the latest beginning
+     * of them is time of impact. At that time overlap along axis is sum
+     * of projected radii of box and segment minus projected distance of
+     * their centers, the least one is depth of contact. Both paths do
+     * the same operations in the same order, so they give equal results.
+     * @param pairs
+     * @param contacts - must have size of pairs
+     * @param begin
+     * @param end
+     */
+    inline void boxSegment(const BoxSegmentPairs& pairs, ContactArrays& contacts,
+                           size_t begin, size_t end) noexcept
+    {
+        const GLfloat* __restrict cx = pairs.cx.data();
+        const GLfloat* __restrict cy = pairs.cy.data();
+        const GLfloat* __restrict ux = pairs.ux.data();
+        const GLfloat* __restrict uy = pairs.uy.data();
+        const GLfloat* __restrict half_w = pairs.half_w.data();
+        const GLfloat* __restrict half_h = pairs.half_h.data();
+        const GLfloat* __restrict mx = pairs.mx.data();
+        const GLfloat* __restrict my = pairs.my.data();
+        const GLfloat* __restrict px = pairs.px.data();
+        const GLfloat* __restrict py = pairs.py.data();
+        const GLfloat* __restrict qx = pairs.qx.data();
+        const GLfloat* __restrict qy = pairs.qy.data();
+        GLfloat* __restrict toi = contacts.toi.data();
+        GLfloat* __restrict depth = contacts.depth.data();
+        GLfloat* __restrict nx = contacts.nx.data();
+        GLfloat* __restrict ny = contacts.ny.data();
+
+        const GLfloat inf = std::numeric_limits<GLfloat>::infinity();
+
+        size_t i = begin;
+#if defined(__AVX__)
+        const __m256 half8 = _mm256_set1_ps(0.5f);
+        const __m256 zero8 = _mm256_setzero_ps();
+        const __m256 one8 = _mm256_set1_ps(1.f);
+        const __m256 inf8 = _mm256_set1_ps(inf);
+        const __m256 ninf8 = _mm256_set1_ps(-inf);
+        const __m256 sign8 = _mm256_set1_ps(-0.f);
+        const auto abs8 = [sign8](__m256 a) { return _mm256_andnot_ps(sign8, a); };
+        // Interval of time when projections on axis overlap
+        const auto sweep8 = [=](__m256 dist, __m256 speed, __m256 radius,
+                                __m256& enter, __m256& exit) {
+            const __m256 inv = _mm256_div_ps(one8, speed);
+            const __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(dist, radius), inv);
+            const __m256 t2 = _mm256_mul_ps(_mm256_add_ps(dist, radius), inv);
+            // Projections which don't move overlap always or never
+            const __m256 still = _mm256_cmp_ps(speed, zero8, _CMP_EQ_OQ);
+            const __m256 inside = _mm256_cmp_ps(abs8(dist), radius, _CMP_LE_OQ);
+            enter = _mm256_blendv_ps(_mm256_min_ps(t1, t2),
+                                     _mm256_blendv_ps(inf8, ninf8, inside), still);
+            exit = _mm256_blendv_ps(_mm256_max_ps(t1, t2),
+                                    _mm256_blendv_ps(ninf8, inf8, inside), still);
+        };
+        for (; i + simd_width <= end; i += simd_width) {
+            const __m256 ux8 = _mm256_loadu_ps(ux + i);
+            const __m256 uy8 = _mm256_loadu_ps(uy + i);
+            const __m256 hw8 = _mm256_loadu_ps(half_w + i);
+            const __m256 hh8 = _mm256_loadu_ps(half_h + i);
+            const __m256 mx8 = _mm256_loadu_ps(mx + i);
+            const __m256 my8 = _mm256_loadu_ps(my + i);
+            const __m256 px8 = _mm256_loadu_ps(px + i);
+            const __m256 py8 = _mm256_loadu_ps(py + i);
+            const __m256 qx8 = _mm256_loadu_ps(qx + i);
+            const __m256 qy8 = _mm256_loadu_ps(qy + i);
+
+            // Half of segment and distance from center of box to its center
+            const __m256 ex = _mm256_mul_ps(_mm256_sub_ps(qx8, px8), half8);
+            const __m256 ey = _mm256_mul_ps(_mm256_sub_ps(qy8, py8), half8);
+            const __m256 dx = _mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(px8, qx8), half8),
+                                            _mm256_loadu_ps(cx + i));
+            const __m256 dy = _mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(py8, qy8), half8),
+                                            _mm256_loadu_ps(cy + i));
+
+            // Normal of segment (ey, -ex) / |e|
+            const __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex),
+                                                            _mm256_mul_ps(ey, ey)));
+            const __m256 sx = _mm256_div_ps(ey, len);
+            const __m256 sy = _mm256_div_ps(_mm256_sub_ps(zero8, ex), len);
+
+            // Width axis of box is (ux, uy), height axis is (-uy, ux)
+            const __m256 radius_u = _mm256_add_ps(hw8, abs8(_mm256_add_ps(
+                    _mm256_mul_ps(ex, ux8), _mm256_mul_ps(ey, uy8))));
+            const __m256 radius_v = _mm256_add_ps(hh8, abs8(_mm256_sub_ps(
+                    _mm256_mul_ps(ey, ux8), _mm256_mul_ps(ex, uy8))));
+            const __m256 radius_s = _mm256_add_ps(
+                    _mm256_mul_ps(hw8, abs8(_mm256_add_ps(_mm256_mul_ps(ux8, sx),
+                                                          _mm256_mul_ps(uy8, sy)))),
+                    _mm256_mul_ps(hh8, abs8(_mm256_sub_ps(_mm256_mul_ps(ux8, sy),
+                                                          _mm256_mul_ps(uy8, sx)))));
+            const __m256 du = _mm256_add_ps(_mm256_mul_ps(dx, ux8), _mm256_mul_ps(dy, uy8));
+            const __m256 dv = _mm256_sub_ps(_mm256_mul_ps(dy, ux8), _mm256_mul_ps(dx, uy8));
+            const __m256 ds = _mm256_add_ps(_mm256_mul_ps(dx, sx), _mm256_mul_ps(dy, sy));
+            const __m256 mu = _mm256_add_ps(_mm256_mul_ps(mx8, ux8), _mm256_mul_ps(my8, uy8));
+            const __m256 mv = _mm256_sub_ps(_mm256_mul_ps(my8, ux8), _mm256_mul_ps(mx8, uy8));
+            const __m256 ms = _mm256_add_ps(_mm256_mul_ps(mx8, sx), _mm256_mul_ps(my8, sy));
+
+            __m256 enter, exit, axis_enter, axis_exit;
+            sweep8(du, mu, radius_u, enter, exit);
+            sweep8(dv, mv, radius_v, axis_enter, axis_exit);
+            enter = _mm256_max_ps(enter, axis_enter);
+            exit = _mm256_min_ps(exit, axis_exit);
+            sweep8(ds, ms, radius_s, axis_enter, axis_exit);
+            enter = _mm256_max_ps(enter, axis_enter);
+            exit = _mm256_min_ps(exit, axis_exit);
+
+            const __m256 hit = _mm256_and_ps(_mm256_and_ps(
+                    _mm256_cmp_ps(enter, exit, _CMP_LE_OQ),
+                    _mm256_cmp_ps(enter, one8, _CMP_LE_OQ)),
+                    _mm256_cmp_ps(exit, zero8, _CMP_GE_OQ));
+            const __m256 time = _mm256_blendv_ps(one8, _mm256_max_ps(enter, zero8), hit);
+
+            // Distances at time of impact or at the end of step
+            const __m256 du_t = _mm256_sub_ps(du, _mm256_mul_ps(time, mu));
+            const __m256 dv_t = _mm256_sub_ps(dv, _mm256_mul_ps(time, mv));
+            const __m256 ds_t = _mm256_sub_ps(ds, _mm256_mul_ps(time, ms));
+
+            // Axis of the least overlap, the first one wins ties
+            __m256 over = _mm256_sub_ps(radius_u, abs8(du_t));
+            __m256 ax = ux8;
+            __m256 ay = uy8;
+            __m256 dist = du_t;
+            __m256 over_axis = _mm256_sub_ps(radius_v, abs8(dv_t));
+            __m256 less = _mm256_cmp_ps(over_axis, over, _CMP_LT_OQ);
+            over = _mm256_blendv_ps(over, over_axis, less);
+            ax = _mm256_blendv_ps(ax, _mm256_sub_ps(zero8, uy8), less);
+            ay = _mm256_blendv_ps(ay, ux8, less);
+            dist = _mm256_blendv_ps(dist, dv_t, less);
+            over_axis = _mm256_sub_ps(radius_s, abs8(ds_t));
+            less = _mm256_cmp_ps(over_axis, over, _CMP_LT_OQ);
+            over = _mm256_blendv_ps(over, over_axis, less);
+            ax = _mm256_blendv_ps(ax, sx, less);
+            ay = _mm256_blendv_ps(ay, sy, less);
+            dist = _mm256_blendv_ps(dist, ds_t, less);
+
+            // Normal points from segment to box, against distance
+            const __m256 flip = _mm256_and_ps(_mm256_cmp_ps(dist, zero8, _CMP_GT_OQ), sign8);
+            _mm256_storeu_ps(toi + i, _mm256_blendv_ps(inf8, time, hit));
+            _mm256_storeu_ps(depth + i, over);
+            _mm256_storeu_ps(nx + i, _mm256_xor_ps(ax, flip));
+            _mm256_storeu_ps(ny + i, _mm256_xor_ps(ay, flip));
+        }
+#elif defined(__SSE2__)
+        const __m128 half4 = _mm_set1_ps(0.5f);
+        const __m128 zero4 = _mm_setzero_ps();
+        const __m128 one4 = _mm_set1_ps(1.f);
+        const __m128 inf4 = _mm_set1_ps(inf);
+        const __m128 ninf4 = _mm_set1_ps(-inf);
+        const __m128 sign4 = _mm_set1_ps(-0.f);
+        const auto abs4 = [sign4](__m128 a) { return _mm_andnot_ps(sign4, a); };
+        // SSE2 has no blend, mask selects b
+        const auto blend4 = [](__m128 a, __m128 b, __m128 mask) {
+            return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+        };
+        const auto sweep4 = [=](__m128 dist, __m128 speed, __m128 radius,
+                                __m128& enter, __m128& exit) {
+            const __m128 inv = _mm_div_ps(one4, speed);
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(dist, radius), inv);
+            const __m128 t2 = _mm_mul_ps(_mm_add_ps(dist, radius), inv);
+            const __m128 still = _mm_cmpeq_ps(speed, zero4);
+            const __m128 inside = _mm_cmple_ps(abs4(dist), radius);
+            enter = blend4(_mm_min_ps(t1, t2), blend4(inf4, ninf4, inside), still);
+            exit = blend4(_mm_max_ps(t1, t2), blend4(ninf4, inf4, inside), still);
+        };
+        for (; i + simd_width <= end; i += simd_width) {
+            const __m128 ux4 = _mm_loadu_ps(ux + i);
+            const __m128 uy4 = _mm_loadu_ps(uy + i);
+            const __m128 hw4 = _mm_loadu_ps(half_w + i);
+            const __m128 hh4 = _mm_loadu_ps(half_h + i);
+            const __m128 mx4 = _mm_loadu_ps(mx + i);
+            const __m128 my4 = _mm_loadu_ps(my + i);
+            const __m128 px4 = _mm_loadu_ps(px + i);
+            const __m128 py4 = _mm_loadu_ps(py + i);
+            const __m128 qx4 = _mm_loadu_ps(qx + i);
+            const __m128 qy4 = _mm_loadu_ps(qy + i);
+
+            const __m128 ex = _mm_mul_ps(_mm_sub_ps(qx4, px4), half4);
+            const __m128 ey = _mm_mul_ps(_mm_sub_ps(qy4, py4), half4);
+            const __m128 dx = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(px4, qx4), half4),
+                                         _mm_loadu_ps(cx + i));
+            const __m128 dy = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(py4, qy4), half4),
+                                         _mm_loadu_ps(cy + i));
+
+            const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ex, ex),
+                                                      _mm_mul_ps(ey, ey)));
+            const __m128 sx = _mm_div_ps(ey, len);
+            const __m128 sy = _mm_div_ps(_mm_sub_ps(zero4, ex), len);
+
+            const __m128 radius_u = _mm_add_ps(hw4, abs4(_mm_add_ps(
+                    _mm_mul_ps(ex, ux4), _mm_mul_ps(ey, uy4))));
+            const __m128 radius_v = _mm_add_ps(hh4, abs4(_mm_sub_ps(
+                    _mm_mul_ps(ey, ux4), _mm_mul_ps(ex, uy4))));
+            const __m128 radius_s = _mm_add_ps(
+                    _mm_mul_ps(hw4, abs4(_mm_add_ps(_mm_mul_ps(ux4, sx),
+                                                    _mm_mul_ps(uy4, sy)))),
+                    _mm_mul_ps(hh4, abs4(_mm_sub_ps(_mm_mul_ps(ux4, sy),
+                                                    _mm_mul_ps(uy4, sx)))));
+            const __m128 du = _mm_add_ps(_mm_mul_ps(dx, ux4), _mm_mul_ps(dy, uy4));
+            const __m128 dv = _mm_sub_ps(_mm_mul_ps(dy, ux4), _mm_mul_ps(dx, uy4));
+            const __m128 ds = _mm_add_ps(_mm_mul_ps(dx, sx), _mm_mul_ps(dy, sy));
+            const __m128 mu = _mm_add_ps(_mm_mul_ps(mx4, ux4), _mm_mul_ps(my4, uy4));
+            const __m128 mv = _mm_sub_ps(_mm_mul_ps(my4, ux4), _mm_mul_ps(mx4, uy4));
+            const __m128 ms = _mm_add_ps(_mm_mul_ps(mx4, sx), _mm_mul_ps(my4, sy));
+
+            __m128 enter, exit, axis_enter, axis_exit;
+            sweep4(du, mu, radius_u, enter, exit);
+            sweep4(dv, mv, radius_v, axis_enter, axis_exit);
+            enter = _mm_max_ps(enter, axis_enter);
+            exit = _mm_min_ps(exit, axis_exit);
+            sweep4(ds, ms, radius_s, axis_enter, axis_exit);
+            enter = _mm_max_ps(enter, axis_enter);
+            exit = _mm_min_ps(exit, axis_exit);
+
+            const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(enter, exit),
+                                                     _mm_cmple_ps(enter, one4)),
+                                          _mm_cmpge_ps(exit, zero4));
+            const __m128 time = blend4(one4, _mm_max_ps(enter, zero4), hit);
+
+            const __m128 du_t = _mm_sub_ps(du, _mm_mul_ps(time, mu));
+            const __m128 dv_t = _mm_sub_ps(dv, _mm_mul_ps(time, mv));
+            const __m128 ds_t = _mm_sub_ps(ds, _mm_mul_ps(time, ms));
+
+            __m128 over = _mm_sub_ps(radius_u, abs4(du_t));
+            __m128 ax = ux4;
+            __m128 ay = uy4;
+            __m128 dist = du_t;
+            __m128 over_axis = _mm_sub_ps(radius_v, abs4(dv_t));
+            __m128 less = _mm_cmplt_ps(over_axis, over);
+            over = blend4(over, over_axis, less);
+            ax = blend4(ax, _mm_sub_ps(zero4, uy4), less);
+            ay = blend4(ay, ux4, less);
+            dist = blend4(dist, dv_t, less);
+            over_axis = _mm_sub_ps(radius_s, abs4(ds_t));
+            less = _mm_cmplt_ps(over_axis, over);
+            over = blend4(over, over_axis, less);
+            ax = blend4(ax, sx, less);
+            ay = blend4(ay, sy, less);
+            dist = blend4(dist, ds_t, less);
+
+            const __m128 flip = _mm_and_ps(_mm_cmpgt_ps(dist, zero4), sign4);
+            _mm_storeu_ps(toi + i, blend4(inf4, time, hit));
+            _mm_storeu_ps(depth + i, over);
+            _mm_storeu_ps(nx + i, _mm_xor_ps(ax, flip));
+            _mm_storeu_ps(ny + i, _mm_xor_ps(ay, flip));
+        }
+#endif
+        // Tail which doesn't fill SIMD register. Comparisons mirror
+        // min and max instructions, so results are equal to SIMD ones.
+        const auto sweep = [inf](GLfloat dist, GLfloat speed, GLfloat radius,
+                                 GLfloat& enter, GLfloat& exit) {
+            if (speed == 0.f) {
+                const bool inside = std::fabs(dist) <= radius;
+                enter = inside ? -inf : inf;
+                exit = inside ? inf : -inf;
+            } else {
+                const GLfloat inv = 1.f / speed;
+                const GLfloat t1 = (dist - radius) * inv;
+                const GLfloat t2 = (dist + radius) * inv;
+                enter = t1 < t2 ? t1 : t2;
+                exit = t1 > t2 ? t1 : t2;
+            }
+        };
+        for (; i < end; ++i) {
+            const GLfloat ex = (qx[i] - px[i]) * 0.5f;
+            const GLfloat ey = (qy[i] - py[i]) * 0.5f;
+            const GLfloat dx = (px[i] + qx[i]) * 0.5f - cx[i];
+            const GLfloat dy = (py[i] + qy[i]) * 0.5f - cy[i];
+
+            const GLfloat len = std::sqrt(ex * ex + ey * ey);
+            const GLfloat sx = ey / len;
+            const GLfloat sy = (0.f - ex) / len;
+
+            const GLfloat radius_u = half_w[i] + std::fabs(ex * ux[i] + ey * uy[i]);
+            const GLfloat radius_v = half_h[i] + std::fabs(ey * ux[i] - ex * uy[i]);
+            const GLfloat radius_s = half_w[i] * std::fabs(ux[i] * sx + uy[i] * sy)
+                                     + half_h[i] * std::fabs(ux[i] * sy - uy[i] * sx);
+            const GLfloat du = dx * ux[i] + dy * uy[i];
+            const GLfloat dv = dy * ux[i] - dx * uy[i];
+            const GLfloat ds = dx * sx + dy * sy;
+            const GLfloat mu = mx[i] * ux[i] + my[i] * uy[i];
+            const GLfloat mv = my[i] * ux[i] - mx[i] * uy[i];
+            const GLfloat ms = mx[i] * sx + my[i] * sy;
+
+            GLfloat enter, exit, axis_enter, axis_exit;
+            sweep(du, mu, radius_u, enter, exit);
+            sweep(dv, mv, radius_v, axis_enter, axis_exit);
+            enter = enter > axis_enter ? enter : axis_enter;
+            exit = exit < axis_exit ? exit : axis_exit;
+            sweep(ds, ms, radius_s, axis_enter, axis_exit);
+            enter = enter > axis_enter ? enter : axis_enter;
+            exit = exit < axis_exit ? exit : axis_exit;
+
+            const bool hit = enter <= exit && enter <= 1.f && exit >= 0.f;
+            const GLfloat time = hit ? (enter > 0.f ? enter : 0.f) : 1.f;
+
+            const GLfloat du_t = du - time * mu;
+            const GLfloat dv_t = dv - time * mv;
+            const GLfloat ds_t = ds - time * ms;
+
+            GLfloat over = radius_u - std::fabs(du_t);
+            GLfloat ax = ux[i];
+            GLfloat ay = uy[i];
+            GLfloat dist = du_t;
+            if (radius_v - std::fabs(dv_t) < over) {
+                over = radius_v - std::fabs(dv_t);
+                ax = 0.f - uy[i];
+                ay = ux[i];
+                dist = dv_t;
+            }
+            if (radius_s - std::fabs(ds_t) < over) {
+                over = radius_s - std::fabs(ds_t);
+                ax = sx;
+                ay = sy;
+                dist = ds_t;
+            }
+
+            toi[i] = hit ? time : inf;
+            depth[i] = over;
+            nx[i] = dist > 0.f ? -ax : ax;
+            ny[i] = dist > 0.f ? -ay : ay;
+        }
+    }
+}
+
+#endif //MOONLANDER_COLLISION_KERNELS_HPP
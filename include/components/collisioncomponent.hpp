@@ -1,11 +1,28 @@
 #ifndef MOONLANDER_COLLISIONCOMPONENT_HPP
 #define MOONLANDER_COLLISIONCOMPONENT_HPP
 
+#include <GL/glew.h>
+
 #include "ecs/component.hpp"
+#include "terrain.hpp"
 
 struct CollisionComponent : ecs::Component
 {
     bool has_collision = false;
+    // Bounding box, doesn't depend on sprite so works without display
+    GLfloat width = 0.f;
+    GLfloat height = 0.f;
+    // Altitude above level, updated by collision system
+    GLfloat altitude = 0.f;
+    TerrainSegment hint;
+    // The first contact with level during the last step, valid if
+    // has_collision. Time of impact is fraction of step, body is
+    // moved back to its position at that time. Normal points out of
+    // segment to body.
+    GLfloat toi = 1.f;
+    TerrainSegment contact;
+    GLfloat penetration = 0.f;
+    vec2 normal{0.f, 0.f};
 };
 
 #endif //MOONLANDER_COLLISIONCOMPONENT_HPP
@@ -0,0 +1,33 @@
+#ifndef MOONLANDER_EMITTERCOMPONENT_HPP
+#define MOONLANDER_EMITTERCOMPONENT_HPP
+
+#include <GL/glew.h>
+
+#include "ecs/component.hpp"
+#include "ecs/entityid.hpp"
+
+/**
+ * Emits particles into pool of other entity while active.
+ * Particles fly from nozzle against direction of entity.
+ */
+struct EmitterComponent : ecs::Component
+{
+    // Entity with ParticleSpriteComponent which receives particles
+    ecs::EntityId pool;
+    bool active = false;
+    // Particles per second
+    GLfloat rate = 0.f;
+    // Speed relative to emitter per reference step
+    GLfloat speed = 0.f;
+    // Standard deviation of direction, radians
+    GLfloat spread = 0.f;
+    // Center of rotation relative to position of entity
+    GLfloat origin_x = 0.f;
+    GLfloat origin_y = 0.f;
+    // Distance from center to nozzle
+    GLfloat nozzle = 0.f;
+    // Fraction of particle left from previous steps
+    GLfloat accumulator = 0.f;
+};
+
+#endif //MOONLANDER_EMITTERCOMPONENT_HPP
@@ -8,7 +8,8 @@
 
 struct KeyboardComponent : ecs::Component
 {
-    std::function<void(const Uint8*)> event_handler;
+    // Called on each simulation step with keyboard state and step length
+    std::function<void(const Uint8*, size_t)> event_handler;
 };
 
 #endif //MOONLANDER_KEYBOARDCOMPONENT_HPP
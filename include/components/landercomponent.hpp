@@ -0,0 +1,28 @@
+#ifndef MOONLANDER_LANDERCOMPONENT_HPP
+#define MOONLANDER_LANDERCOMPONENT_HPP
+
+#include "ecs/component.hpp"
+#include "utils/inputscript.hpp"
+
+enum class LanderState
+{
+    FLYING,
+    LANDED,
+    CRASHED
+};
+
+/**
+ * Ship which lands by itself, many of them share one level.
+ * Lander which touched level stays where it touched it.
+ */
+struct LanderComponent : ecs::Component
+{
+    LanderState state = LanderState::FLYING;
+    // Input replayed by lander, lander without script is
+    // controlled by KeyboardComponent
+    const utils::InputScript* script = nullptr;
+    // Step when lander landed or crashed
+    size_t steps = 0;
+};
+
+#endif //MOONLANDER_LANDERCOMPONENT_HPP
@@ -2,14 +2,12 @@
 #define MOONLANDER_LEVELCOMPONENT_HPP
 
 #include "ecs/component.hpp"
-
-using glm::vec2;
+#include "terrain.hpp"
 
 struct LevelComponent : ecs::Component
 {
-    std::vector<vec2> points;
-    std::vector<vec2> stars;
-    std::vector<vec2> platforms;
+    // Chunks of level loaded around ship
+    Terrain terrain;
 
     GLfloat scale_factor = 1.f;
 };
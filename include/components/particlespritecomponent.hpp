@@ -5,28 +5,25 @@
 
 #include "ecs/component.hpp"
 #include "render/sprite.hpp"
+#include "particle/particlepool.hpp"
 
 /**
- * Particle Sprite Component. Each particle is clip of one sprite.
+ * Particle Sprite Component. Each particle is clip of one sprite,
+ * sprite is loaded once and shared by all particles ever spawned
+ * into the pool.
  */
 struct ParticleSpriteComponent : ecs::Component
 {
-    bool is_alive = false;
-    GLfloat life_time;
-
     std::shared_ptr<Sprite> sprite;
 
-    /**
-     * Vector that contains coordinate of each particle
-     * in tuple <x, y, angle>
-     */
-    std::vector<utils::Position> coords;
+    // Particles bounce off level instead of falling through it
+    bool terrain_collision = false;
 
     /**
-     * Vector that contains velocity of each particle
-     * in tuple <vel_x, vel_y, vel_angle>
+     * Alive particles: coordinates <x, y, angle>, velocities
+     * <vel_x, vel_y, vel_angle>, ages and clips
      */
-    std::vector<utils::Position> vel;
+    ParticlePool particles;
 };
 
 #endif //MOONLANDER_PARTICLESPRITECOMPONENT_HPP
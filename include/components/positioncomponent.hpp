@@ -12,6 +12,12 @@ struct PositionComponent : ecs::Component
     GLfloat angle;
     GLfloat scale_factor = 1.f;
     GLfloat scallable = true;
+
+    // State before the last simulation step, rendered
+    // position is interpolated between it and current one
+    GLfloat prev_x = 0.f;
+    GLfloat prev_y = 0.f;
+    GLfloat prev_angle = 0.f;
 };
 
 #endif //MOONLANDER_POSITIONCOMPONENT_HPP
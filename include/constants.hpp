@@ -8,6 +8,32 @@ const GLfloat weight = 150.f;
 const GLfloat engine_force = 1.f;
 const GLfloat rot_step = 0.002f;
 
+// Number of particles of one cloud processed by one task
+const size_t particle_grain = 4096;
+// Number of pairs of box and segment tested by one task and number of
+// bodies whose contacts are resolved by one task
+const size_t collision_grain = 1024;
+const size_t body_grain = 256;
+
+// Velocities and forces above are per reference step, microseconds.
+// Simulation step of other length scales them.
+const size_t reference_step = 1000000 / 60;
+// Default number of simulation steps per second
+const size_t sim_tick_rate = 60;
+// Maximal number of simulation steps per rendered frame
+const size_t max_catch_up_steps = 5;
+
+// Stages of systems: simulation is updated on each fixed step,
+// rendering once per frame
+const size_t simulation_stage = 0;
+const size_t render_stage = 1;
+
+// Virtual screen of headless simulation which has no display
+const GLuint headless_screen_width = 1920;
+const GLuint headless_screen_height = 1080;
+// Default limit of steps of one headless landing
+const size_t headless_max_steps = 60 * 60 * 5;
+
 const std::string RESOURCE_PATH = "../res/";
 const std::string SHADER_PATH = "../src/shaders/";
 
@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "world.hpp"
+#include "utils/fixedclock.hpp"
 
 #define WINDOW_FLAGS (SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL | SDL_WINDOW_FULLSCREEN)
 #define IMG_FLAGS IMG_INIT_PNG
@@ -35,7 +36,24 @@ public:
 
     void flush();
 
-    void update(size_t delta);
+    /**
+     * Simulate fixed steps which fit into elapsed time
+     * and render interpolated state
+     * @param elapsed - real time since previous frame, microseconds
+     */
+    void update(size_t elapsed);
+
+    /**
+     * Set number of simulation steps per second
+     * @param tickRate
+     */
+    void setTickRate(size_t tickRate);
+
+    /**
+     * Set seed of level, must be called before initGame
+     * @param seed
+     */
+    void setSeed(std::uint64_t seed) noexcept;
 
 private:
     GLuint m_screenWidth;
@@ -44,6 +62,7 @@ public:
     bool vsync_supported;
 private:
     World m_world;
+    utils::FixedClock m_clock;
 };
 
 #endif //MOONLANDER_GAME_HPP
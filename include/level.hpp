@@ -1,38 +1,47 @@
 #ifndef MOONLANDER_LEVEL_HPP
 #define MOONLANDER_LEVEL_HPP
 
+#include <cstdint>
 #include <vector>
 #include <glm/vec2.hpp>
 #include <GL/glew.h>
 
-#include "render/camera.hpp"
+#include "terrain.hpp"
 
 using glm::vec2;
 
+/**
+ * Generator of level chunks. Chunk is pure function of seed and its
+ * index, so evicted chunk is recreated exactly and chunks can be
+ * generated in any order.
+ */
 class Level
 {
 public:
     explicit Level();
     ~Level();
-    void extendToRight(const Camera& camera);
-    void extendToLeft(const Camera& camera);
-    void extendToUp(std::vector<vec2>::iterator left,
-                    std::vector<vec2>::iterator right);
+
+    /**
+     * Generate chunk of level
+     * @param index - index of chunk
+     * @return
+     */
+    LevelChunkPtr generate(std::ptrdiff_t index) const;
 
     // Need to be set after sdl initialized
     GLfloat height_min;
     GLfloat height_max;
 
-    GLfloat max_left;
-    GLfloat max_right;
-
-    std::vector<vec2> platforms;
-    std::vector<vec2> points;
-    std::vector<vec2> stars;
+    std::uint64_t seed;
 
 private:
-    GLfloat point_dist_min;
-    GLfloat point_dist_max;
+    /**
+     * Height of surface at left border of chunk, surfaces of
+     * neighbour chunks meet there
+     * @param index - index of chunk
+     * @return
+     */
+    GLfloat border_height(std::ptrdiff_t index) const;
 };
 
 
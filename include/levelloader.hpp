@@ -0,0 +1,91 @@
+#ifndef MOONLANDER_LEVELLOADER_HPP
+#define MOONLANDER_LEVELLOADER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "level.hpp"
+#include "terrain.hpp"
+#include "utils/spscqueue.hpp"
+
+/**
+ * Loads chunks of level to terrain. Chunks ahead of ship are generated
+ * by worker thread and handed to main thread by lock-free queues, so
+ * loading of prefetched chunk only moves pointer. Chunk which is needed
+ * but isn't ready yet is generated by calling thread.
+ */
+class LevelLoader
+{
+public:
+    /**
+     * @param async - generate chunks by worker thread, otherwise
+     * each chunk is generated when it is needed
+     */
+    explicit LevelLoader(bool async);
+    ~LevelLoader();
+
+    LevelLoader(const LevelLoader&) = delete;
+    LevelLoader& operator=(const LevelLoader&) = delete;
+
+    /**
+     * Start generation of level, worker keeps its copy
+     * @param level
+     */
+    void start(const Level& level);
+
+    /**
+     * Load chunks [first, last] to terrain, request chunks which follow
+     * them in direction of motion and evict chunks far from them
+     * @param terrain
+     * @param first - index of the first needed chunk
+     * @param last - index of the last needed chunk
+     * @param direction - sign of horizontal velocity, chunks are
+     * requested at both sides if it is zero
+     */
+    void load(Terrain& terrain, std::ptrdiff_t first, std::ptrdiff_t last,
+              int direction);
+
+private:
+    static constexpr size_t queue_size = 64;
+
+    Level m_level;
+    bool m_async;
+
+    // Indices of chunks requested from worker
+    utils::SpscQueue<std::ptrdiff_t, queue_size> m_requests;
+    // Generated chunks
+    utils::SpscQueue<LevelChunkPtr, queue_size> m_chunks;
+
+    // Main thread only: chunks which were received but aren't
+    // needed yet and indices which weren't received yet
+    std::map<std::ptrdiff_t, LevelChunkPtr> m_ready;
+    std::set<std::ptrdiff_t> m_pending;
+
+    std::thread m_worker;
+    std::atomic<bool> m_stop = false;
+    // Only sleeping worker waits for it, main thread never locks
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+
+    void work();
+
+    /**
+     * Take received chunk or generate it
+     * @param index
+     * @return
+     */
+    LevelChunkPtr take(std::ptrdiff_t index);
+
+    /**
+     * Request chunk if it isn't loaded, received or requested
+     * @param terrain
+     * @param index
+     */
+    void request(const Terrain& terrain, std::ptrdiff_t index);
+};
+
+#endif //MOONLANDER_LEVELLOADER_HPP
@@ -0,0 +1,92 @@
+#ifndef MOONLANDER_KERNELS_HPP
+#define MOONLANDER_KERNELS_HPP
+
+#include <GL/glew.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "particle/particlearrays.hpp"
+
+namespace particle
+{
+    /**
+     * Number of particles processed by one instruction. Instruction set
+     * is chosen at compile time: AVX if enabled (e.g. -mavx), SSE2 on
+     * x86-64 otherwise, scalar code on other platforms.
+     */
+#if defined(__AVX__)
+    constexpr size_t simd_width = 8;
+#elif defined(__SSE2__)
+    constexpr size_t simd_width = 4;
+#else
+    constexpr size_t simd_width = 1;
+#endif
+
+    /**
+     * Move particles in [begin, end) by velocities and apply gravity
+     * to velocities in one pass. Result is the same as of movement
+     * followed by gravity step, multiplication isn't fused with
+     * addition, so SIMD and scalar paths give equal results.
+     * @param coords
+     * @param vel
+     * @param k - step scale of velocities
+     * @param gravity - change of vertical velocity per step
+     * @param begin
+     * @param end
+     */
+    inline void integrate(ParticleArrays& coords, ParticleArrays& vel,
+                          GLfloat k, GLfloat gravity,
+                          size_t begin, size_t end) noexcept
+    {
+        GLfloat* __restrict x = coords.x.data();
+        GLfloat* __restrict y = coords.y.data();
+        GLfloat* __restrict angle = coords.angle.data();
+        const GLfloat* __restrict vx = vel.x.data();
+        GLfloat* __restrict vy = vel.y.data();
+        const GLfloat* __restrict vangle = vel.angle.data();
+
+        // Arrays are aligned, loads are unaligned only because range
+        // may begin anywhere, aligned begin doesn't split cache lines
+        size_t i = begin;
+#if defined(__AVX__)
+        const __m256 k8 = _mm256_set1_ps(k);
+        const __m256 gravity8 = _mm256_set1_ps(gravity);
+        for (; i + simd_width <= end; i += simd_width) {
+            const __m256 vy8 = _mm256_loadu_ps(vy + i);
+            _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i),
+                    _mm256_mul_ps(_mm256_loadu_ps(vx + i), k8)));
+            _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i),
+                    _mm256_mul_ps(vy8, k8)));
+            _mm256_storeu_ps(angle + i, _mm256_add_ps(_mm256_loadu_ps(angle + i),
+                    _mm256_mul_ps(_mm256_loadu_ps(vangle + i), k8)));
+            _mm256_storeu_ps(vy + i, _mm256_add_ps(vy8, gravity8));
+        }
+#elif defined(__SSE2__)
+        const __m128 k4 = _mm_set1_ps(k);
+        const __m128 gravity4 = _mm_set1_ps(gravity);
+        for (; i + simd_width <= end; i += simd_width) {
+            const __m128 vy4 = _mm_loadu_ps(vy + i);
+            _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i),
+                    _mm_mul_ps(_mm_loadu_ps(vx + i), k4)));
+            _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i),
+                    _mm_mul_ps(vy4, k4)));
+            _mm_storeu_ps(angle + i, _mm_add_ps(_mm_loadu_ps(angle + i),
+                    _mm_mul_ps(_mm_loadu_ps(vangle + i), k4)));
+            _mm_storeu_ps(vy + i, _mm_add_ps(vy4, gravity4));
+        }
+#endif
+        // Tail which doesn't fill SIMD register
+        for (; i < end; ++i) {
+            x[i] += vx[i] * k;
+            y[i] += vy[i] * k;
+            angle[i] += vangle[i] * k;
+            vy[i] += gravity;
+        }
+    }
+}
+
+#endif //MOONLANDER_KERNELS_HPP
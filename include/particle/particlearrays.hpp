@@ -0,0 +1,71 @@
+#ifndef MOONLANDER_PARTICLEARRAYS_HPP
+#define MOONLANDER_PARTICLEARRAYS_HPP
+
+#include <GL/glew.h>
+
+#include "utils/utils.hpp"
+#include "utils/alignedallocator.hpp"
+
+/**
+ * Triples <x, y, angle> of particles stored as structure of arrays.
+ * Each attribute is contiguous aligned array, so kernels process
+ * several particles by one SIMD instruction (see kernels.hpp).
+ */
+struct ParticleArrays
+{
+    utils::aligned_vector<GLfloat> x;
+    utils::aligned_vector<GLfloat> y;
+    utils::aligned_vector<GLfloat> angle;
+
+    size_t size() const noexcept
+    {
+        return x.size();
+    }
+
+    void reserve(size_t size)
+    {
+        x.reserve(size);
+        y.reserve(size);
+        angle.reserve(size);
+    }
+
+    void push_back(const utils::Position& pos)
+    {
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        angle.push_back(pos.angle);
+    }
+
+    void set(size_t idx, const utils::Position& pos) noexcept
+    {
+        x[idx] = pos.x;
+        y[idx] = pos.y;
+        angle[idx] = pos.angle;
+    }
+
+    /**
+     * Remove triple idx in O(1) moving the last one to its place
+     * @param idx
+     */
+    void swapRemove(size_t idx) noexcept
+    {
+        set(idx, (*this)[size() - 1]);
+        x.pop_back();
+        y.pop_back();
+        angle.pop_back();
+    }
+
+    void clear() noexcept
+    {
+        x.clear();
+        y.clear();
+        angle.clear();
+    }
+
+    utils::Position operator[](size_t idx) const noexcept
+    {
+        return {x[idx], y[idx], angle[idx]};
+    }
+};
+
+#endif //MOONLANDER_PARTICLEARRAYS_HPP
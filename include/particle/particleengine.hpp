@@ -3,62 +3,45 @@
 
 #include "render/sprite.hpp"
 #include "ecs/entity.hpp"
-#include "components/spritecomponent.hpp"
-#include "components/velocitycomponent.hpp"
 #include "components/particlespritecomponent.hpp"
+#include "particleprogram.hpp"
 
 class ParticleEngine
 {
 public:
 
     /**
-     * Return clips.size() number generated particles from specific texture
-     * Each particle is Entity with SpriteComponent, ParticleComponent,
-     * PositionComponent and VelocityComponent
-     * Each particle named by convention "Particle {number of particle}"
+     * Make entity en emitter of particles which look like clips of
+     * specific texture. Texture is loaded once, particles are spawned
+     * later into pool of capacity particles, clip of particle is
+     * index in clips.
+     * Entity receives ParticleSpriteComponent
+     * @param en
      * @param texture_file
      * @param clips
-     * @return
+     * @param capacity
+     * @param life_time - microseconds
      */
     template <int Length>
-    static std::shared_ptr<Entity>
-    generateFromTexture(const std::string& texture_file,
-                        const std::array<utils::Rect, Length>& clips,
-                        const std::vector<utils::Position>& init_coords,
-                        const std::vector<utils::Position>& init_vel,
-                        GLfloat life_time)
+    static void
+    createPool(Entity en, const std::string& texture_file,
+               const std::array<utils::Rect, Length>& clips,
+               size_t capacity, GLfloat life_time)
     {
-        assert(clips.size() == init_coords.size()
-               && "Number of particles must be "
-                  "the same as number of coordinates");
+        static_assert(Length <= ParticleProgram::max_clips,
+                      "Instanced particle shader doesn't support so many clips");
 
-        assert(init_coords.size() == init_vel.size()
-               && "Number of coordinates must be "
-                  "the same as number of velocities");
+        en.addComponent<ParticleSpriteComponent>();
+        en.activate();
 
-        auto en = std::make_shared<Entity>();
-        en->addComponent<ParticleSpriteComponent>();
-        en->addComponent<VelocityComponent>();
-        en->activate();
-
-        auto particle = en->getComponent<ParticleSpriteComponent>();
+        auto particle = en.getComponent<ParticleSpriteComponent>();
         particle->sprite = std::make_shared<Sprite>(texture_file);
-        particle->is_alive = true;
-        particle->life_time = life_time;
+        particle->particles = ParticlePool(capacity, life_time);
 
-        for (size_t i = 0; i < clips.size(); ++i) {
-            particle->sprite->addClipSprite(clips[i]);
-            particle->coords.push_back({init_coords[i].x,
-                                        init_coords[i].y,
-                                        init_coords[i].angle});
-            particle->vel.push_back({init_vel[i].x,
-                                     init_vel[i].y,
-                                     init_vel[i].angle});
-        }
+        for (const auto& clip: clips)
+            particle->sprite->addClipSprite(clip);
 
         particle->sprite->generateDataBuffer();
-
-        return en;
     }
 
 private:
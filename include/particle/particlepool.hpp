@@ -0,0 +1,163 @@
+#ifndef MOONLANDER_PARTICLEPOOL_HPP
+#define MOONLANDER_PARTICLEPOOL_HPP
+
+#include <GL/glew.h>
+#include <vector>
+#include <cassert>
+
+#include "particle/particlearrays.hpp"
+
+/**
+ * Particles of fixed capacity. Memory of all arrays is reserved once,
+ * so spawning and expiring of particles never allocates. Alive
+ * particles are dense: expired particle is replaced by the last one.
+ * When pool is full new particles recycle slots in ring order.
+ */
+class ParticlePool
+{
+public:
+    ParticlePool() = default;
+
+    /**
+     * @param capacity - maximal number of alive particles
+     * @param lifeTime - age when particle expires, microseconds
+     */
+    ParticlePool(size_t capacity, GLfloat lifeTime)
+            : m_capacity(capacity), m_lifeTime(lifeTime)
+    {
+        m_coords.reserve(capacity);
+        m_vel.reserve(capacity);
+        m_age.reserve(capacity);
+        m_clip.reserve(capacity);
+    }
+
+    /**
+     * Add particle in O(1)
+     * @param coords
+     * @param vel
+     * @param clip - index of sprite clip of particle
+     * @return index of particle
+     */
+    size_t spawn(const utils::Position& coords, const utils::Position& vel,
+                 GLuint clip)
+    {
+        assert(m_capacity > 0 && "Pool has no capacity");
+
+        if (size() < m_capacity) {
+            m_coords.push_back(coords);
+            m_vel.push_back(vel);
+            m_age.push_back(0.f);
+            m_clip.push_back(clip);
+            return size() - 1;
+        }
+
+        const size_t idx = m_cursor;
+        m_cursor = (m_cursor + 1) % m_capacity;
+        m_coords.set(idx, coords);
+        m_vel.set(idx, vel);
+        m_age[idx] = 0.f;
+        m_clip[idx] = clip;
+        return idx;
+    }
+
+    /**
+     * Age particles and remove ones which outlived life time
+     * @param delta - microseconds
+     */
+    void expire(GLfloat delta) noexcept
+    {
+        for (size_t i = 0; i < size();) {
+            m_age[i] += delta;
+            // Moved last particle is checked at the same index
+            if (m_age[i] >= m_lifeTime)
+                remove(i);
+            else
+                ++i;
+        }
+    }
+
+    /**
+     * Remove all particles keeping memory
+     */
+    void clear() noexcept
+    {
+        m_coords.clear();
+        m_vel.clear();
+        m_age.clear();
+        m_clip.clear();
+        m_cursor = 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_age.size();
+    }
+
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    GLfloat getLifeTime() const noexcept
+    {
+        return m_lifeTime;
+    }
+
+    ParticleArrays& getCoords() noexcept
+    {
+        return m_coords;
+    }
+
+    const ParticleArrays& getCoords() const noexcept
+    {
+        return m_coords;
+    }
+
+    ParticleArrays& getVel() noexcept
+    {
+        return m_vel;
+    }
+
+    const ParticleArrays& getVel() const noexcept
+    {
+        return m_vel;
+    }
+
+    const utils::aligned_vector<GLfloat>& getAge() const noexcept
+    {
+        return m_age;
+    }
+
+    const std::vector<GLuint>& getClips() const noexcept
+    {
+        return m_clip;
+    }
+
+private:
+    ParticleArrays m_coords;
+    ParticleArrays m_vel;
+    utils::aligned_vector<GLfloat> m_age;
+    std::vector<GLuint> m_clip;
+
+    size_t m_capacity = 0;
+    GLfloat m_lifeTime = 0.f;
+    // Slot recycled by the next spawn into full pool
+    size_t m_cursor = 0;
+
+    /**
+     * Swap-remove particle idx
+     * @param idx
+     */
+    void remove(size_t idx) noexcept
+    {
+        const size_t last = size() - 1;
+        m_coords.swapRemove(idx);
+        m_vel.swapRemove(idx);
+        m_age[idx] = m_age[last];
+        m_age.pop_back();
+        m_clip[idx] = m_clip[last];
+        m_clip.pop_back();
+    }
+};
+
+#endif //MOONLANDER_PARTICLEPOOL_HPP
@@ -0,0 +1,77 @@
+#ifndef MOONLANDER_PARTICLEPROGRAM_HPP
+#define MOONLANDER_PARTICLEPROGRAM_HPP
+
+#include <memory>
+#include <vector>
+
+#include "render/shaderprogram.hpp"
+#include "render/sprite.hpp"
+#include "particle/particlepool.hpp"
+
+/**
+ * Program which draws all particles of pool by one instanced call.
+ * Position, angle and clip of each particle are written to instance
+ * buffer, quad of particle is built in vertex shader.
+ * Matrices are shared with MoonLanderProgram by uniform binding point,
+ * so they are updated by it.
+ */
+class ParticleProgram: public ShaderProgram
+{
+protected:
+    static std::shared_ptr<ParticleProgram> instance;
+public:
+    // Maximal number of clips of particle sprite
+    static constexpr size_t max_clips = 16;
+
+    ParticleProgram() = default;
+
+    static std::shared_ptr<ParticleProgram> getInstance()
+    {
+        if (!instance)
+            instance = std::make_shared<ParticleProgram>();
+
+        return instance;
+    }
+
+    ~ParticleProgram();
+
+    /**
+     * Draw particles of pool at coords - vel * back
+     * @param sprite - texture with clips of particles
+     * @param pool
+     * @param back - distance back to interpolated state in velocities
+     * @param scale
+     */
+    void draw(const Sprite& sprite, const ParticlePool& pool,
+              GLfloat back, GLfloat scale);
+
+    void updateProjection() override;
+    void updateView() override;
+    void updateModel() override;
+
+    /**
+     * Init program and buffers
+     */
+    void loadProgram() override;
+
+private:
+    GLint m_texLoc = -1;
+    GLint m_clipsLoc = -1;
+    GLint m_textureSizeLoc = -1;
+    GLint m_scaleLoc = -1;
+
+    GLuint m_vao = 0;
+    GLuint m_quadVBO = 0;
+    GLuint m_EBO = 0;
+    GLuint m_instanceVBO = 0;
+    // Number of particles instance buffer can hold
+    size_t m_instanceCapacity = 0;
+    // x, y, angle and clip of each particle
+    std::vector<GLfloat> m_instances;
+
+    GLint uniform_location(const std::string& name);
+    void reserve_instances(size_t count);
+    void free_buffers();
+};
+
+#endif //MOONLANDER_PARTICLEPROGRAM_HPP
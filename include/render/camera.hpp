@@ -2,8 +2,12 @@
 #define CAMERA_HPP
 
 #include <GL/glew.h>
-#include <functional>
+#include <glm/mat4x4.hpp>
 
+/**
+ * Camera in world coordinates. World isn't moved by camera,
+ * camera is applied by view matrix.
+ */
 class Camera
 {
 public:
@@ -16,11 +20,21 @@ public:
     void setX(GLfloat x);
     void setY(GLfloat y);
 
-    GLfloat deltaX() const;
-    GLfloat deltaY() const;
-
     void translate(GLfloat x, GLfloat y);
 
+    /**
+     * Remember position before simulation step for interpolation
+     */
+    void save();
+
+    /**
+     * View matrix of camera interpolated between saved and current position
+     * @param alpha - part of step passed since position was saved, in [0, 1]
+     * @param scale - scale of world, it is applied by model matrix
+     * @return
+     */
+    glm::mat4 getView(GLfloat alpha, GLfloat scale) const;
+
 private:
     GLfloat m_x;
     GLfloat m_y;
@@ -29,4 +43,4 @@ private:
     GLfloat m_prevY;
 };
 
-#endif //CAMERA_HPP
\ No newline at end of file
+#endif //CAMERA_HPP
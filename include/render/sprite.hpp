@@ -16,6 +16,7 @@ public:
     void load(const std::string& path);
     GLuint addClipSprite(utils::Rect clip);
     utils::Rect getClip(GLuint idx) noexcept;
+    const std::vector<utils::Rect>& getClips() const noexcept;
 
     GLuint getWidth() const noexcept override;
     GLuint getHeight() const noexcept override;
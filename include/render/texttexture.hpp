@@ -15,6 +15,10 @@ public:
     ~TextTexture() override;
 
     void load(const std::string& textureText, SDL_Color color, TTF_Font* font);
+    /**
+     * Render text, texture is kept if text is the same as current one
+     * @param text
+     */
     void setText(const std::string& text);
     void setFont(TTF_Font* font);
     void setColor(SDL_Color color);
@@ -18,6 +18,12 @@ public:
     virtual GLuint getWidth() const noexcept;
     virtual GLuint getHeight() const noexcept;
 
+    /**
+     * Size of whole texture in pixels
+     */
+    GLuint getTextureWidth() const noexcept;
+    GLuint getTextureHeight() const noexcept;
+
     virtual GLuint getVAO() const = 0;
     virtual void generateDataBuffer() = 0;
 
@@ -0,0 +1,65 @@
+#ifndef MOONLANDER_VERTEXBUFFER_HPP
+#define MOONLANDER_VERTEXBUFFER_HPP
+
+#include <GL/glew.h>
+#include <glm/vec2.hpp>
+
+using glm::vec2;
+
+namespace render
+{
+    /**
+     * Persistent buffer of 2d vertices which grows in both directions.
+     * Vertices are kept in the middle of GPU storage, so adding to
+     * either end uploads only new vertices. When there is no room
+     * storage is reallocated twice bigger and old vertices are copied
+     * on GPU side.
+     */
+    class VertexBuffer
+    {
+    public:
+        VertexBuffer() = default;
+        ~VertexBuffer();
+
+        VertexBuffer(const VertexBuffer&) = delete;
+        VertexBuffer& operator=(const VertexBuffer&) = delete;
+
+        void pushFront(const vec2* vertices, size_t count);
+        void pushBack(const vec2* vertices, size_t count);
+
+        /**
+         * Forget vertices, storage isn't freed
+         * @param count
+         */
+        void popFront(size_t count) noexcept;
+        void popBack(size_t count) noexcept;
+        void clear() noexcept;
+
+        size_t size() const noexcept;
+
+        /**
+         * Draw all vertices as primitives of mode
+         * @param mode - e.g. GL_LINES
+         */
+        void draw(GLenum mode) const;
+
+    private:
+        GLuint m_vao = 0;
+        GLuint m_vbo = 0;
+        // Number of vertices storage can hold
+        size_t m_capacity = 0;
+        // Vertices occupy [m_begin, m_end) of storage
+        size_t m_begin = 0;
+        size_t m_end = 0;
+
+        /**
+         * Make room for front vertices before and back vertices
+         * after stored ones
+         * @param front
+         * @param back
+         */
+        void reserve(size_t front, size_t back);
+    };
+}
+
+#endif //MOONLANDER_VERTEXBUFFER_HPP
@@ -0,0 +1,64 @@
+#ifndef MOONLANDER_SIMULATION_HPP
+#define MOONLANDER_SIMULATION_HPP
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+#include "game.hpp"
+#include "constants.hpp"
+#include "utils/inputscript.hpp"
+
+/**
+ * Outcome of one lander of headless landing
+ */
+struct SimulationResult
+{
+    // WIN, FAIL or NORMAL if landing didn't finish in time
+    GameStates state;
+    size_t steps;
+    GLfloat fuel;
+};
+
+/**
+ * Landings without display, audio device and GPU. Each landing
+ * runs in new headless World driven by input script on fixed
+ * steps as fast as possible, so SDL doesn't need to be initialized.
+ * Several landers may land at once over the same level, each of
+ * them replays the script from its own place, and they are updated
+ * in parallel. Level of n-th landing is generated by seed + n, so
+ * landings are reproducible.
+ */
+class Simulation
+{
+public:
+    /**
+     * @param script - input of each landing
+     * @param tickRate - number of steps per simulated second
+     * @param maxSteps - landing which takes longer is stopped
+     * @param seed - seed of level of the first landing
+     * @param landers - number of landers of each landing
+     */
+    explicit Simulation(utils::InputScript script,
+                        size_t tickRate = sim_tick_rate,
+                        size_t maxSteps = headless_max_steps,
+                        std::uint64_t seed = 0, size_t landers = 1);
+
+    /**
+     * Simulate one landing from start till each lander wins or fails
+     * or till step limit
+     * @return outcome of each lander
+     */
+    std::vector<SimulationResult> run();
+
+private:
+    utils::InputScript m_script;
+    size_t m_step;
+    size_t m_maxSteps;
+    std::uint64_t m_seed;
+    size_t m_landers;
+    // Number of finished landings
+    size_t m_runs = 0;
+};
+
+#endif //MOONLANDER_SIMULATION_HPP
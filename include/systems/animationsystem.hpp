@@ -10,7 +10,8 @@
  * Only entities which hold SpriteComponent and AnimationComponent both
  * can be animated.
  */
-class AnimationSystem : public ecs::System<SpriteComponent, AnimationComponent>
+class AnimationSystem : public ecs::System<ecs::Write<SpriteComponent>,
+        ecs::Read<AnimationComponent>>
 {
     void update_state(size_t delta) override;
 };
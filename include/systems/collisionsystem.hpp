@@ -1,24 +1,49 @@
 #ifndef MOONLANDER_COLLISIONSYSTEM_HPP
 #define MOONLANDER_COLLISIONSYSTEM_HPP
 
+#include <vector>
+
+#include "utils/utils.hpp"
+#include "collision/boxsegmentpairs.hpp"
 #include "components/collisioncomponent.hpp"
-#include "components/spritecomponent.hpp"
 #include "components/levelcomponent.hpp"
 #include "components/positioncomponent.hpp"
 #include "ecs/system.hpp"
 
 using glm::vec2;
 
-class CollisionSystem : public ecs::System<CollisionComponent, SpriteComponent,
-        LevelComponent, PositionComponent>
+/**
+ * Collision of bounding boxes of CollisionComponent with level.
+ * Doesn't use sprites, so also runs in headless simulation.
+ * Boxes are swept from previous position to current one, so fast body
+ * doesn't pass through level, and body which hit level is moved back
+ * to position of impact. Boxes are paired with segments near their
+ * paths by terrain index, then all pairs are tested by batch kernel and
+ * contacts of each body are resolved on thread pool.
+ */
+class CollisionSystem : public ecs::System<ecs::Write<CollisionComponent>,
+        ecs::Read<LevelComponent>, ecs::Write<PositionComponent>>
 {
     void update_state(size_t delta) override;
 
 private:
-    bool levelSpriteCollision(const Sprite &sprite,
-                              GLfloat ship_x,
-                              GLfloat ship_y, const std::vector<vec2>& points,
-                              const std::vector<vec2>& stars, GLfloat angle);
+    /**
+     * Body and its pairs, which are contiguous
+     */
+    struct Body
+    {
+        CollisionComponent* col;
+        PositionComponent* pos;
+        size_t first;
+        size_t last;
+    };
+
+    // Kept between updates, so pairs don't allocate each step
+    BoxSegmentPairs m_pairs;
+    ContactArrays m_contacts;
+    std::vector<Body> m_bodies;
+    // Segment of each pair
+    std::vector<TerrainSegment> m_segments;
 };
 
 #endif //MOONLANDER_COLLISIONSYSTEM_HPP
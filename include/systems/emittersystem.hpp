@@ -0,0 +1,33 @@
+#ifndef MOONLANDER_EMITTERSYSTEM_HPP
+#define MOONLANDER_EMITTERSYSTEM_HPP
+
+#include "components/emittercomponent.hpp"
+#include "components/positioncomponent.hpp"
+#include "components/velocitycomponent.hpp"
+#include "ecs/system.hpp"
+#include "utils/random.hpp"
+#include "utils/profilecounter.hpp"
+
+/**
+ * Spawns particles of active emitters into their pools.
+ * Pools have fixed capacity, so emission doesn't allocate.
+ */
+class EmitterSystem : public ecs::System<ecs::Write<EmitterComponent>,
+        ecs::Read<PositionComponent>, ecs::Read<VelocityComponent>>
+{
+public:
+    explicit EmitterSystem();
+
+    void update_state(size_t delta) override;
+
+    /**
+     * @return time spent in updates
+     */
+    utils::ProfileCounter& getCounter() noexcept;
+
+private:
+    utils::Random m_rand;
+    utils::ProfileCounter m_counter;
+};
+
+#endif //MOONLANDER_EMITTERSYSTEM_HPP
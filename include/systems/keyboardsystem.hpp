@@ -4,9 +4,27 @@
 #include "components/keyboardcomponent.hpp"
 #include "ecs/system.hpp"
 
-class KeyboardSystem : public ecs::System<KeyboardComponent>
+/**
+ * Calls event handlers of keyboard components.
+ * Handlers control the ship, so system is considered to write
+ * ship components. Runs on main thread because of SDL.
+ */
+class KeyboardSystem : public ecs::System<ecs::Read<KeyboardComponent>>
 {
+public:
+    explicit KeyboardSystem();
+
     void update_state(size_t delta) override;
+
+    /**
+     * Use state instead of SDL keyboard, e.g. scripted input of
+     * headless simulation. nullptr returns to SDL keyboard.
+     * @param state - array indexed by SDL scancodes
+     */
+    void setKeyboardState(const Uint8* state) noexcept;
+
+private:
+    const Uint8* m_state = nullptr;
 };
 
 #endif //MOONLANDER_KEYBOARDSYSTEM_HPP
@@ -0,0 +1,61 @@
+#ifndef MOONLANDER_LANDERSYSTEM_HPP
+#define MOONLANDER_LANDERSYSTEM_HPP
+
+#include "components/collisioncomponent.hpp"
+#include "components/landercomponent.hpp"
+#include "components/levelcomponent.hpp"
+#include "components/lifetimecomponent.hpp"
+#include "components/positioncomponent.hpp"
+#include "components/velocitycomponent.hpp"
+#include "ecs/system.hpp"
+#include "utils/inputscript.hpp"
+
+/**
+ * Landers are updated independently of each other on thread pool:
+ * lander which hit level either landed on platform or crashed,
+ * flying one is steered by its input script and burns its fuel.
+ * LifeTimeComponent of lander is its fuel.
+ */
+class LanderSystem : public ecs::System<LanderComponent, VelocityComponent,
+        LifeTimeComponent, ecs::Read<PositionComponent>,
+        ecs::Read<CollisionComponent>, ecs::Read<LevelComponent>>
+{
+public:
+    void update_state(size_t delta) override;
+
+    /**
+     * Set number of current step, scripts are replayed by it
+     * @param step
+     */
+    void setStep(size_t step) noexcept;
+
+    /**
+     * Apply engine and rotation to lander
+     * @param controls
+     * @param pos
+     * @param vel
+     * @param fuel
+     * @param k - step scale
+     * @return whether engine works, it doesn't without fuel
+     */
+    static bool steer(const utils::InputScript::Controls& controls,
+                      const PositionComponent& pos, VelocityComponent& vel,
+                      LifeTimeComponent& fuel, GLfloat k) noexcept;
+
+    /**
+     * Whether lander which hit level stands on platform
+     * @param terrain
+     * @param pos
+     * @param vel
+     * @param col
+     * @return
+     */
+    static bool landed(const Terrain& terrain, const PositionComponent& pos,
+                       const VelocityComponent& vel,
+                       const CollisionComponent& col) noexcept;
+
+private:
+    size_t m_step = 0;
+};
+
+#endif //MOONLANDER_LANDERSYSTEM_HPP
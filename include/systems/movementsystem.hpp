@@ -10,10 +10,12 @@
 
 /**
  * System that can handle game objects with
- * Position and Direction components, like spaceship
+ * Position and Direction components, like spaceship.
+ * Also integrates particles including their gravity.
  */
 class MovementSystem: public
-        ecs::System<PositionComponent, VelocityComponent, ParticleSpriteComponent>
+        ecs::System<ecs::Write<PositionComponent>, ecs::Read<VelocityComponent>,
+                ecs::Write<ParticleSpriteComponent>>
 {
 public:
     explicit MovementSystem();
@@ -1,13 +1,40 @@
 #ifndef MOONLANDER_PARTICLERENDERSYSTEM_HPP
 #define MOONLANDER_PARTICLERENDERSYSTEM_HPP
 
+#include <GL/glew.h>
+#include <glm/mat4x4.hpp>
+
+#include "constants.hpp"
 #include "ecs/system.hpp"
 #include "components/particlespritecomponent.hpp"
 
-class ParticleRenderSystem : public ecs::System<ParticleSpriteComponent>
+class ParticleRenderSystem : public ecs::System<ecs::Read<ParticleSpriteComponent>>
 {
 public:
+    explicit ParticleRenderSystem();
+
     void update_state(size_t delta) override;
+
+    /**
+     * Set part of simulation step passed since the last step.
+     * Particles don't keep previous state, it is restored by velocity.
+     * @param alpha - in [0, 1]
+     * @param step - length of simulation step, microseconds
+     */
+    void setInterpolation(GLfloat alpha, size_t step);
+
+    /**
+     * Set view matrix of camera and scale of world
+     * @param view
+     * @param scale
+     */
+    void setView(const glm::mat4& view, GLfloat scale);
+
+private:
+    GLfloat m_alpha = 1.f;
+    size_t m_step = reference_step;
+    glm::mat4 m_view = glm::mat4(1.f);
+    GLfloat m_scale = 1.f;
 };
 
 #endif //MOONLANDER_PARTICLERENDERSYSTEM_HPP
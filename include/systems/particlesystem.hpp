@@ -0,0 +1,29 @@
+#ifndef MOONLANDER_PARTICLESYSTEM_HPP
+#define MOONLANDER_PARTICLESYSTEM_HPP
+
+#include "components/particlespritecomponent.hpp"
+#include "components/levelcomponent.hpp"
+#include "ecs/system.hpp"
+#include "utils/profilecounter.hpp"
+
+/**
+ * Ages particles and removes expired ones from their pools.
+ * Particles of pools with terrain collision bounce off level.
+ */
+class ParticleSystem : public ecs::System<ParticleSpriteComponent>
+{
+public:
+    explicit ParticleSystem();
+
+    void update_state(size_t delta) override;
+
+    /**
+     * @return time spent in updates
+     */
+    utils::ProfileCounter& getCounter() noexcept;
+
+private:
+    utils::ProfileCounter m_counter;
+};
+
+#endif //MOONLANDER_PARTICLESYSTEM_HPP
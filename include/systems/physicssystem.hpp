@@ -2,10 +2,9 @@
 #define MOONLANDER_PHYSICSSYSTEM_HPP
 
 #include "components/velocitycomponent.hpp"
-#include "components/particlespritecomponent.hpp"
 #include "ecs/system.hpp"
 
-class PhysicsSystem : public ecs::System <VelocityComponent, ParticleSpriteComponent>
+class PhysicsSystem : public ecs::System<ecs::Write<VelocityComponent>>
 {
 public:
     void update_state(size_t delta) override;
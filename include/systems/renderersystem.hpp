@@ -2,9 +2,12 @@
 #define MOONLANDER_RENDERERSYSTEM_HPP
 
 #include <GL/glew.h>
+#include <deque>
 
 #include "moonlanderprogram.hpp"
 #include "render/camera.hpp"
+#include "render/vertexbuffer.hpp"
+#include "terrain.hpp"
 #include "components/textcomponent.hpp"
 #include "ecs/system.hpp"
 #include "components/positioncomponent.hpp"
@@ -12,16 +15,68 @@
 /**
  * System that can handle level surface
  */
-class RendererSystem : public ecs::System<PositionComponent, TextComponent>
+class RendererSystem : public ecs::System<ecs::Read<PositionComponent>,
+        ecs::Read<TextComponent>>
 {
 public:
     explicit RendererSystem();
 
     void update_state(size_t delta) override;
+
+    /**
+     * Set part of simulation step passed since the last step,
+     * entities are drawn between their previous and current state
+     * @param alpha - in [0, 1]
+     */
+    void setInterpolation(GLfloat alpha);
+
+    /**
+     * Set view matrix of camera. Entities which aren't scallable
+     * are drawn in screen coordinates without it.
+     * @param view
+     */
+    void setView(const glm::mat4& view);
 private:
+    /**
+     * Level geometry resident on GPU. Vertices of chunks are stored
+     * in world coordinates, they are uploaded when chunk is loaded.
+     */
+    struct LevelBuffer
+    {
+        render::VertexBuffer vertices;
+        // Index of the first chunk in buffer
+        std::ptrdiff_t first = 0;
+        // Number of vertices of each chunk in buffer
+        std::deque<size_t> counts;
+
+        /**
+         * Upload chunks which buffer doesn't have and forget
+         * chunks which terrain doesn't have
+         * @param terrain
+         * @param data - array of chunk kept by buffer
+         */
+        void sync(const Terrain& terrain, std::vector<vec2> LevelChunk::* data);
+
+        void clear() noexcept;
+    };
+
     void drawSprites();
     void drawLevel();
     void drawText();
+
+    /**
+     * Upload view matrix to program
+     * @param view
+     */
+    void use_view(const glm::mat4& view);
+
+    GLfloat m_alpha = 1.f;
+    glm::mat4 m_view = glm::mat4(1.f);
+
+    ecs::EntityId m_level;
+    LevelBuffer m_points;
+    LevelBuffer m_stars;
+    LevelBuffer m_platforms;
 };
 
 #endif //MOONLANDER_RENDERERSYSTEM_HPP
@@ -0,0 +1,249 @@
+#ifndef MOONLANDER_TERRAIN_HPP
+#define MOONLANDER_TERRAIN_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <GL/glew.h>
+
+using glm::vec2;
+
+/**
+ * Vertical bounds of segment of surface
+ */
+struct SegmentBounds
+{
+    GLfloat min_y;
+    GLfloat max_y;
+};
+
+/**
+ * Part of level between x = index * chunk_width and
+ * x = (index + 1) * chunk_width
+ */
+struct LevelChunk
+{
+    // Interior segments are wider than a cell, so the walk from the
+    // first segment of cell is bounded by a few steps
+    static constexpr GLfloat cell_width = 16.f;
+
+    std::ptrdiff_t index = 0;
+    // Surface sorted by x, the first point lies on left border of chunk.
+    // Segment i joins points[i] with points[i + 1] or, for the last
+    // point, with next, which is the first point of the next chunk.
+    std::vector<vec2> points;
+    vec2 next;
+    // Pairs of points of landing platforms sorted by x
+    std::vector<vec2> platforms;
+    std::vector<vec2> stars;
+
+    // Broad phase of surface: bounds of each segment and the first
+    // segment of each cell of uniform grid along x
+    std::vector<SegmentBounds> bounds;
+    std::vector<std::uint16_t> cells;
+
+    /**
+     * Build broad phase, must be called when points are final
+     */
+    void buildIndex();
+
+    /**
+     * @param segment
+     * @return right point of segment
+     */
+    const vec2& segmentEnd(size_t segment) const noexcept
+    {
+        return segment + 1 < points.size() ? points[segment + 1] : next;
+    }
+
+    /**
+     * Find segment which contains x
+     * @param x - is clamped to chunk
+     * @return
+     */
+    size_t segmentAt(GLfloat x) const noexcept;
+};
+
+using LevelChunkPtr = std::shared_ptr<const LevelChunk>;
+
+/**
+ * Segment of surface by index of its chunk. Segment found by the last
+ * query of body is kept as hint, bodies move little between steps, so
+ * the next query of body starts from it. Hint stays valid when its
+ * chunk is evicted, since chunk is regenerated exactly.
+ */
+struct TerrainSegment
+{
+    std::ptrdiff_t chunk = 0;
+    size_t segment = 0;
+};
+
+/**
+ * Chunks of level keyed by index. Chunks follow each other without
+ * gaps, so level can grow and shrink only at its ends. Chunks are
+ * shared and never modified, so copying of terrain is cheap.
+ */
+class Terrain
+{
+public:
+    static constexpr GLfloat chunk_width = 2000.f;
+
+    /**
+     * @param x
+     * @return index of chunk which contains x
+     */
+    static std::ptrdiff_t chunkIndex(GLfloat x) noexcept
+    {
+        return static_cast<std::ptrdiff_t>(std::floor(x / chunk_width));
+    }
+
+    bool empty() const noexcept;
+    size_t size() const noexcept;
+
+    /**
+     * @return index of the first chunk
+     */
+    std::ptrdiff_t firstIndex() const noexcept;
+
+    /**
+     * @return index after the last chunk
+     */
+    std::ptrdiff_t endIndex() const noexcept;
+
+    bool contains(std::ptrdiff_t index) const noexcept;
+    const LevelChunk& chunk(std::ptrdiff_t index) const;
+
+    /**
+     * @return x coordinate of the first point of surface
+     */
+    GLfloat left() const;
+
+    /**
+     * @return x coordinate of the last point of surface, it is
+     * right border of the last chunk
+     */
+    GLfloat right() const;
+
+    /**
+     * Add chunk before the first one, its index must precede it
+     * @param chunk
+     */
+    void pushFront(LevelChunkPtr chunk);
+
+    /**
+     * Add chunk after the last one, its index must follow it
+     * @param chunk
+     */
+    void pushBack(LevelChunkPtr chunk);
+
+    void popFront();
+    void popBack();
+    void clear() noexcept;
+
+    /**
+     * Return y coordinate of surface at x. Surface is extended
+     * horizontally beyond borders of terrain.
+     * @param x
+     * @return
+     */
+    GLfloat height(GLfloat x) const;
+
+    /**
+     * Return y coordinate of surface at x starting search from hint
+     * @param x
+     * @param hint - is updated by found segment
+     * @return
+     */
+    GLfloat height(GLfloat x, TerrainSegment& hint) const;
+
+    /**
+     * Return altitude at (x, y)
+     * @param x
+     * @param y
+     * @return
+     */
+    GLfloat altitude(GLfloat x, GLfloat y) const;
+    GLfloat altitude(GLfloat x, GLfloat y, TerrainSegment& hint) const;
+
+    /**
+     * Call f(left, right, segment) for each segment of surface whose
+     * bounding box overlaps box [min, max], e.g. bounding box of
+     * oriented box
+     * @tparam F
+     * @param min
+     * @param max
+     * @param f
+     */
+    template<typename F>
+    void forEachSegment(vec2 min, vec2 max, F f) const;
+
+    /**
+     * Call f(left, right) for each platform which overlaps
+     * range [left, right] by x
+     * @tparam F
+     * @param left
+     * @param right
+     * @param f
+     */
+    template<typename F>
+    void forEachPlatform(GLfloat left, GLfloat right, F f) const;
+
+private:
+    std::deque<LevelChunkPtr> m_chunks;
+    std::ptrdiff_t m_first = 0;
+
+    /**
+     * Find segment of surface which contains x
+     * @param x - must be in [left(), right()]
+     * @return
+     */
+    TerrainSegment segment(GLfloat x) const;
+
+    /**
+     * @param segment
+     * @param x
+     * @return y coordinate of segment at x
+     */
+    GLfloat interpolate(const TerrainSegment& segment, GLfloat x) const;
+};
+
+template<typename F>
+void Terrain::forEachSegment(vec2 min, vec2 max, F f) const
+{
+    if (empty() || max.x < left() || min.x > right())
+        return;
+
+    const std::ptrdiff_t last = std::min(chunkIndex(max.x), endIndex() - 1);
+    for (auto index = std::max(chunkIndex(min.x), m_first); index <= last; ++index) {
+        const LevelChunk& cur = chunk(index);
+        for (size_t i = cur.segmentAt(min.x);
+             i < cur.points.size() && cur.points[i].x <= max.x; ++i)
+            if (cur.bounds[i].max_y >= min.y && cur.bounds[i].min_y <= max.y)
+                f(cur.points[i], cur.segmentEnd(i), TerrainSegment{index, i});
+    }
+}
+
+template<typename F>
+void Terrain::forEachPlatform(GLfloat left, GLfloat right, F f) const
+{
+    if (empty())
+        return;
+
+    // Platform can't cross border of chunk
+    const std::ptrdiff_t last = std::min(chunkIndex(right), endIndex() - 1);
+    for (auto index = std::max(chunkIndex(left), m_first); index <= last; ++index) {
+        const auto& platforms = chunk(index).platforms;
+        assert(platforms.size() % 2 == 0);
+        for (size_t i = 0; i < platforms.size(); i += 2)
+            if (platforms[i + 1].x >= left && platforms[i].x <= right)
+                f(platforms[i], platforms[i + 1]);
+    }
+}
+
+#endif //MOONLANDER_TERRAIN_HPP
@@ -0,0 +1,66 @@
+#ifndef ALIGNEDALLOCATOR_HPP
+#define ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * Alignment of SIMD data, enough for AVX registers
+     * and equal to cache line
+     */
+    constexpr size_t simd_alignment = 64;
+
+    /**
+     * Allocator of memory aligned to Alignment bytes
+     * @tparam T
+     * @tparam Alignment
+     */
+    template<class T, size_t Alignment = simd_alignment>
+    struct AlignedAllocator
+    {
+        typedef T value_type;
+
+        template<class U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, Alignment> other;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+        {}
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T),
+                                                  std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* p, size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+        template<class U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept
+        {
+            return true;
+        }
+
+        template<class U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept
+        {
+            return false;
+        }
+    };
+
+    template<class T>
+    using aligned_vector = std::vector<T, AlignedAllocator<T>>;
+}
+
+#endif //ALIGNEDALLOCATOR_HPP
@@ -43,6 +43,39 @@ namespace coll
         return {{x,  y}, {bx, by}, {cx, cy}, {dx, dy}};
     }
 
+    /**
+     * Rectangle by its center, unit vector along its width and halves
+     * of its sizes. Vector along its height is (-axis.y, axis.x).
+     */
+    struct OrientedBox
+    {
+        vec2 center;
+        vec2 axis;
+        GLfloat half_w;
+        GLfloat half_h;
+    };
+
+    /**
+     * Build oriented box of the same rectangle as buildRectPoints()
+     * @param rect
+     * @param alpha
+     * @return
+     */
+    inline OrientedBox
+    buildOrientedBox(const utils::Rect &rect, GLfloat alpha) noexcept
+    {
+        alpha -= glm::two_pi<GLfloat>()
+                 * std::floor(alpha / glm::two_pi<GLfloat>());
+
+        const GLfloat alpha_cos = std::cos(-alpha);
+        const GLfloat alpha_sin = std::sin(-alpha);
+        const vec2 axis(alpha_cos, -alpha_sin);
+        const vec2 up(alpha_sin, alpha_cos);
+
+        return {vec2(rect.x, rect.y) + axis * (rect.w / 2.f) + up * (rect.h / 2.f),
+                axis, rect.w / 2.f, rect.h / 2.f};
+    }
+
     /**
      * Check whether first line (p11, p12) intersect with second (p21, p22)
      * @param p11
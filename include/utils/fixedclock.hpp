@@ -0,0 +1,85 @@
+#ifndef FIXEDCLOCK_HPP
+#define FIXEDCLOCK_HPP
+
+#include <cstddef>
+
+namespace utils
+{
+    /**
+     * Clock of fixed timestep simulation.
+     * Real time of frames is accumulated and spent by steps of
+     * fixed length, the rest is used to interpolate rendered state
+     * between the last two steps. Time is in microseconds.
+     */
+    class FixedClock
+    {
+    public:
+        /**
+         * @param tickRate - number of steps per second
+         * @param maxSteps - maximal number of steps per frame. If frame
+         * took longer, simulation slows down instead of spending each
+         * frame on catching up.
+         */
+        FixedClock(size_t tickRate, size_t maxSteps) noexcept
+                : m_step(1000000 / tickRate), m_maxSteps(maxSteps),
+                  m_accumulator(0)
+        {}
+
+        /**
+         * Add real time of frame
+         * @param elapsed
+         * @return number of steps which must be simulated
+         */
+        size_t advance(size_t elapsed) noexcept
+        {
+            m_accumulator += elapsed;
+            size_t steps = m_accumulator / m_step;
+            if (steps > m_maxSteps) {
+                // Drop time which can't be caught up
+                steps = m_maxSteps;
+                m_accumulator %= m_step;
+            } else {
+                m_accumulator -= steps * m_step;
+            }
+
+            return steps;
+        }
+
+        /**
+         * Part of step passed since the last simulated one, in [0, 1).
+         * Rendered state is previous state + alpha * (current - previous).
+         * @return
+         */
+        float getAlpha() const noexcept
+        {
+            return static_cast<float>(m_accumulator) / m_step;
+        }
+
+        /**
+         * Length of step
+         * @return
+         */
+        size_t getStep() const noexcept
+        {
+            return m_step;
+        }
+
+        void setTickRate(size_t tickRate) noexcept
+        {
+            m_step = 1000000 / tickRate;
+            m_accumulator = 0;
+        }
+
+        void setMaxSteps(size_t maxSteps) noexcept
+        {
+            m_maxSteps = maxSteps;
+        }
+
+    private:
+        size_t m_step;
+        size_t m_maxSteps;
+        size_t m_accumulator;
+    };
+}
+
+#endif //FIXEDCLOCK_HPP
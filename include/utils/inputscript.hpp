@@ -0,0 +1,71 @@
+#ifndef INPUTSCRIPT_HPP
+#define INPUTSCRIPT_HPP
+
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+namespace utils
+{
+    /**
+     * Keyboard input of headless simulation.
+     * Script consists of lines "<step> <keys>", keys are held from
+     * the step till the next line: U - engine, L - rotate left,
+     * R - rotate right, "-" - nothing pressed. Lines beginning
+     * with # are comments. Steps must increase.
+     */
+    class InputScript
+    {
+    public:
+        /**
+         * Keys held at step
+         */
+        struct Controls
+        {
+            bool up = false;
+            bool left = false;
+            bool right = false;
+        };
+
+        InputScript() = default;
+
+        /**
+         * Load script from file
+         * @param path
+         */
+        explicit InputScript(const std::string& path);
+
+        /**
+         * Hold keys starting from step
+         * @param step
+         * @param keys
+         */
+        void add(size_t step, const std::string& keys);
+
+        /**
+         * @param step
+         * @return keys held at step
+         */
+        Controls controls(size_t step) const noexcept;
+
+        /**
+         * Fill keyboard state of step
+         * @param step
+         * @param keys - array indexed by SDL scancodes
+         */
+        void apply(size_t step, Uint8* keys) const noexcept;
+
+    private:
+        struct Entry
+        {
+            size_t step;
+            bool up;
+            bool left;
+            bool right;
+        };
+
+        std::vector<Entry> m_entries;
+    };
+}
+
+#endif //INPUTSCRIPT_HPP
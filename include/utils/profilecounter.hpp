@@ -0,0 +1,70 @@
+#ifndef PROFILECOUNTER_HPP
+#define PROFILECOUNTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace utils
+{
+    /**
+     * Time spent in section of code, e.g. in update of system.
+     * Average is taken over calls since the last reset().
+     */
+    class ProfileCounter
+    {
+    public:
+        void add(std::chrono::nanoseconds time) noexcept
+        {
+            m_time.fetch_add(time.count(), std::memory_order_relaxed);
+            m_calls.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @return average time of call, microseconds
+         */
+        float getAverage() const noexcept
+        {
+            const size_t calls = getCalls();
+            return calls ? m_time.load(std::memory_order_relaxed) / 1000.f / calls
+                         : 0.f;
+        }
+
+        size_t getCalls() const noexcept
+        {
+            return m_calls.load(std::memory_order_relaxed);
+        }
+
+        void reset() noexcept
+        {
+            m_time.store(0, std::memory_order_relaxed);
+            m_calls.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> m_time = 0;
+        std::atomic<size_t> m_calls = 0;
+    };
+
+    /**
+     * Adds time of its scope to counter
+     */
+    class ScopedProfile
+    {
+    public:
+        explicit ScopedProfile(ProfileCounter& counter) noexcept
+                : m_counter(counter), m_start(std::chrono::steady_clock::now())
+        {}
+
+        ~ScopedProfile()
+        {
+            m_counter.add(std::chrono::steady_clock::now() - m_start);
+        }
+
+    private:
+        ProfileCounter& m_counter;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
+#endif //PROFILECOUNTER_HPP
@@ -3,6 +3,9 @@
 
 #include <random>
 #include <ctime>
+#include <cmath>
+#include <cstdint>
+#include <glm/gtc/constants.hpp>
 
 namespace utils
 {
@@ -128,6 +131,99 @@ namespace utils
     private:
         std::mt19937 m_generator;
     };
+
+    /**
+     * Counter-based generator: n-th number is pure function of
+     * (seed, key, stream, n), so any part of sequence can be
+     * recreated without generating what precedes it. Distributions
+     * are computed here instead of std ones, so numbers are independent
+     * of implementation of <random> distributions. Gaussian numbers
+     * use std::log and std::cos, which aren't correctly rounded by
+     * each libm, so they may differ slightly between platforms.
+     */
+    class CounterRandom
+    {
+    public:
+        /**
+         * @param seed - seed of world
+         * @param key - e.g. index of generated object
+         * @param stream - independent sequence of the same key
+         */
+        explicit CounterRandom(std::uint64_t seed, std::int64_t key,
+                               std::uint64_t stream = 0) noexcept
+                : m_key(mix(mix(seed ^ mix(static_cast<std::uint64_t>(key)))
+                            + stream)), m_counter(0) {}
+
+        /**
+         * Next 64 random bits
+         * @return
+         */
+        std::uint64_t next() noexcept
+        {
+            return mix(m_key + golden_gamma * ++m_counter);
+        }
+
+        /**
+         * Generate number of type T with uniform distribution
+         * in range [a, b]
+         * @tparam T
+         * @param a
+         * @param b
+         * @return T
+         */
+        template<typename T>
+        typename std::enable_if<std::is_arithmetic_v<T>, T>::type
+        generateu(T a, T b) noexcept
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                return a + static_cast<T>((b - a) * unit());
+            else
+                return a + static_cast<T>(next() % (static_cast<std::uint64_t>(b - a) + 1));
+        }
+
+        /**
+         * Generate number of type T with gaussian distribution
+         * by Box-Muller transform
+         * @tparam T
+         * @param mean - mean value
+         * @param std - standard deviation
+         * @return
+         */
+        template<typename T>
+        typename std::enable_if<std::is_floating_point_v<T>, T>::type
+        generaten(T mean, T std) noexcept
+        {
+            const double radius = std::sqrt(-2. * std::log(1. - unit()));
+            const double angle = 2. * glm::pi<double>() * unit();
+            return mean + std * static_cast<T>(radius * std::cos(angle));
+        }
+
+    private:
+        static constexpr std::uint64_t golden_gamma = 0x9E3779B97F4A7C15ULL;
+
+        std::uint64_t m_key;
+        std::uint64_t m_counter;
+
+        /**
+         * Finalizer of SplitMix64
+         * @param z
+         * @return
+         */
+        static constexpr std::uint64_t mix(std::uint64_t z) noexcept
+        {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * @return uniform number in [0, 1)
+         */
+        double unit() noexcept
+        {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+    };
 }
 
 #endif //RANDOM_HPP
@@ -0,0 +1,69 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace utils
+{
+    /**
+     * Lock-free queue of one producer and one consumer thread.
+     * Elements are kept in ring of Capacity slots, producer owns tail
+     * and consumer owns head, so neither push nor pop ever blocks.
+     */
+    template<typename T, size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                      "Capacity must be power of two");
+    public:
+        /**
+         * Add value, producer only
+         * @param value - isn't moved from if queue is full
+         * @return false if queue is full
+         */
+        bool push(T&& value)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+                return false;
+
+            m_items[tail % Capacity] = std::move(value);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Take the oldest value, consumer only
+         * @param value
+         * @return false if queue is empty
+         */
+        bool pop(T& value)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false;
+
+            value = std::move(m_items[head % Capacity]);
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_head.load(std::memory_order_acquire)
+                   == m_tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::array<T, Capacity> m_items;
+        // Indices grow without wrap, slot is index % Capacity.
+        // They are on separate cache lines, so threads don't share them.
+        alignas(64) std::atomic<size_t> m_head = 0;
+        alignas(64) std::atomic<size_t> m_tail = 0;
+    };
+}
+
+#endif //SPSCQUEUE_HPP
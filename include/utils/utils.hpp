@@ -52,18 +52,6 @@ namespace utils
         return res;
     }
 
-    /**
-     * Return corrected cords. It's needed because when camera
-     * moves all non-static objects moves also.
-     * @param coords
-     * @param camPos
-     * @return
-     */
-    constexpr glm::vec2 fix_coords(const vec2& coords, const vec2& camPos)
-    {
-        return {coords.x + camPos.x, coords.y + camPos.y};
-    }
-
     /**
      * Return Surface format
      * if surface format can't be recognized 0 will be returned
@@ -108,7 +96,7 @@ namespace utils
         size_t i = 0;
         for (GLfloat y = clip.y; y < clip.y + clip.h; y += part_height)
             for (GLfloat x = clip.x; x < clip.x + clip.w; x += part_width)
-                clips[++i] = {x, y, part_width, part_height};
+                clips[i++] = {x, y, part_width, part_height};
 
         return clips;
     }
@@ -116,14 +104,14 @@ namespace utils
     namespace physics
     {
         /**
-         * Return altitude at (x, y). Can be used also to get y coordinate
-         * of altitude y at point x.
-         * @param points
-         * @param x
-         * @param y
+         * Scale of per reference step quantities for step of length delta
+         * @param delta - length of simulation step, microseconds
          * @return
          */
-        GLfloat altitude(const std::vector<vec2>& points, GLfloat x, GLfloat y);
+        inline GLfloat step_scale(size_t delta) noexcept
+        {
+            return static_cast<GLfloat>(delta) / reference_step;
+        }
     }
 
     /**
@@ -1,74 +1,209 @@
 #ifndef MOONLANDER_WORLD_HPP
 #define MOONLANDER_WORLD_HPP
 
-#include <unordered_map>
+#include <vector>
 #include <memory>
 #include <string>
+#include <array>
+#include <random>
+#include <cstdint>
 #include <SDL_ttf.h>
 
 #include "utils/fps.hpp"
 #include "level.hpp"
+#include "levelloader.hpp"
 #include "utils/timer.hpp"
 #include "utils/utils.hpp"
 #include "ecs/basesystem.hpp"
 #include "render/camera.hpp"
 #include "utils/audio.hpp"
+#include "utils/inputscript.hpp"
 #include "ecs/ecsmanager.hpp"
+#include "systems/renderersystem.hpp"
+#include "systems/particlerendersystem.hpp"
+#include "systems/particlesystem.hpp"
+#include "systems/emittersystem.hpp"
+#include "systems/landersystem.hpp"
 
 using ecs::Entity;
 
 class World: public ecs::EcsManager
 {
 public:
-    World() : m_scaled(false), m_wasInit(false), m_realCamX(0.f){};
+    /**
+     * @param headless - simulate without display, audio and GPU:
+     * sprites, text, sound and rendering systems aren't created and
+     * ship is controlled by input script
+     * @param threads - number of threads of systems, by default one for
+     * headless world and number of hardware threads otherwise
+     */
+    explicit World(bool headless = false, size_t threads = 0)
+            : ecs::EcsManager(threads ? threads
+                                      : headless ? 1 : std::thread::hardware_concurrency()),
+              m_scaled(false), m_headless(headless),
+              m_wasInit(false), m_levelLoader(!headless)
+    {
+        setSeed(std::random_device()());
+    }
     ~World() = default;
 
     void init() override;
+
+    /**
+     * Simulate one fixed step
+     * @param delta - length of step, microseconds
+     */
     void update(size_t delta) override;
 
+    /**
+     * Draw state interpolated between the last two steps
+     * @param alpha - part of step passed since the last one, in [0, 1]
+     * @param step - length of step, microseconds
+     */
+    void render(GLfloat alpha, size_t step);
+
+    /**
+     * Set input of headless simulation, script must outlive world
+     * @param script
+     */
+    void setInputScript(const utils::InputScript* script) noexcept;
+
+    /**
+     * Set seed of level, world with the same seed has the same level.
+     * Must be called before init.
+     * @param seed
+     */
+    void setSeed(std::uint64_t seed) noexcept;
+
+    /**
+     * Set number of landers of headless world, the first of them is ship
+     * and others start right of it. Each of them replays input script.
+     * Must be called before init.
+     * @param count
+     */
+    void setLanders(size_t count) noexcept;
+
+    /**
+     * @return number of steps simulated since init
+     */
+    size_t getSteps() const noexcept;
+
+    /**
+     * @return number of landers including ship
+     */
+    size_t getLanders() const noexcept;
+
+    /**
+     * @param idx - index of lander, ship is the first one
+     * @return state of lander
+     */
+    LanderComponent getLander(size_t idx);
+
+    /**
+     * @return whether any lander is flying
+     */
+    bool isFlying();
+
+    /**
+     * @param idx - index of lander, ship is the first one
+     * @return fuel left in lander
+     */
+    GLfloat getFuel(size_t idx = 0);
+
 private:
-    std::unordered_map<size_t, std::shared_ptr<Entity>> m_nonStatic;
+    ecs::EntityId m_ship;
+    ecs::EntityId m_level;
+    ecs::EntityId m_shipParticle;
+    ecs::EntityId m_exhaust;
+    ecs::EntityId m_fpsText;
+    ecs::EntityId m_particlesText;
+    ecs::EntityId m_velX;
+    ecs::EntityId m_velY;
+    ecs::EntityId m_alt;
+    ecs::EntityId m_fuel;
+    ecs::EntityId m_time;
+    ecs::EntityId m_earth;
+    ecs::EntityId m_fail;
+    ecs::EntityId m_win;
+
     Camera m_camera;
     GLuint m_screenHeight;
     GLuint m_screenWidth;
     GLfloat m_frameHeight;
     GLfloat m_frameWidth;
 
-    // Need to save camera pos after ship dead
-    // Because camera will be reset.
-    GLfloat m_realCamX;
-
     utils::Timer m_timer;
 
     utils::Fps m_fps;
 
+    // Rendering systems get interpolation factor before each frame
+    RendererSystem* m_renderer = nullptr;
+    ParticleRenderSystem* m_particleRenderer = nullptr;
+    // Cost of particles is shown in debug build
+    EmitterSystem* m_emitter = nullptr;
+    ParticleSystem* m_particleSystem = nullptr;
+    LanderSystem* m_landerSystem = nullptr;
+
+    /**
+     * Remember state before simulation step for interpolation
+     */
+    void save_state();
+
     /**
-     * Update position of components
+     * Reset previous state of entities whose positions were added
+     * after tick since, they have nothing to interpolate from
+     * @param since
      */
-    void update_movables();
+    void snap_positions(ecs::Tick since);
 
-    void update_ship();
+    void update_ship(size_t delta);
+    void explode_ship();
     void update_text();
     void update_level();
+
+    /**
+     * Load chunks of level around [left, right] and evict far ones
+     * @param left
+     * @param right
+     * @param direction - sign of horizontal velocity of landers,
+     * chunks are prefetched in it
+     */
+    void load_level(GLfloat left, GLfloat right, int direction = 0);
     void rescale_world();
     void init_sound();
     void init_sprites();
     void init_text();
     void init_level();
     void init_ship();
-    TTF_Font* open_font(const std::string& font, size_t fontSize);
+    void init_landers();
 
     /**
-     * Remove all entities that not alive
+     * Set initial state of lander of components common to all landers
+     * @param lander
+     * @param x
      */
-    void filter_entities();
+    void init_lander(Entity lander, GLfloat x);
+    void init_particles();
+    TTF_Font* open_font(const std::string& font, size_t fontSize);
 
     bool m_scaled;
     const GLfloat m_scaleFactor = 1.5f;
     utils::audio::Audio m_audio;
     Level level;
 
+    bool m_headless;
+    // Keyboard state of headless simulation indexed by SDL scancodes,
+    // no key is held there since landers replay input script
+    std::array<Uint8, SDL_NUM_SCANCODES> m_keys{};
+    const utils::InputScript* m_input = nullptr;
+    size_t m_steps = 0;
+    // Ship is the first lander
+    std::vector<ecs::EntityId> m_landers;
+    size_t m_landerCount = 1;
+
     bool m_wasInit;
+    // Generates chunks of level ahead of ship
+    LevelLoader m_levelLoader;
 };
 
 #endif //MOONLANDER_WORLD_HPP
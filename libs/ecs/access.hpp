@@ -0,0 +1,106 @@
+#ifndef ACCESS_HPP
+#define ACCESS_HPP
+
+namespace ecs
+{
+    /**
+     * Row filter of forEach() by change ticks
+     */
+    enum class Filter
+    {
+        None,
+        Changed,
+        Added
+    };
+
+    /**
+     * Declares that system only reads ComponentType:
+     * class AnimationSystem : public ecs::System<Read<AnimationComponent>,
+     *                                            Write<SpriteComponent>>
+     * Systems which only read the same components may run concurrently.
+     * @tparam ComponentType
+     */
+    template<class ComponentType>
+    struct Read
+    {
+    };
+
+    /**
+     * Declares that system modifies ComponentType
+     * @tparam ComponentType
+     */
+    template<class ComponentType>
+    struct Write
+    {
+    };
+
+    /**
+     * Read ComponentType and skip entities whose ComponentType wasn't
+     * changed since the previous update of system:
+     * forEach<Write<SpriteComponent>, Changed<AnimationComponent>>(...)
+     * Component is changed when it is added, written by forEach() or
+     * marked by Entity::markChanged().
+     * @tparam ComponentType
+     */
+    template<class ComponentType>
+    struct Changed
+    {
+    };
+
+    /**
+     * Read ComponentType and skip entities which got
+     * ComponentType before the previous update of system
+     * @tparam ComponentType
+     */
+    template<class ComponentType>
+    struct Added
+    {
+    };
+
+    /**
+     * Unwrap Read/Write/Changed/Added declaration.
+     * Component without wrapper is considered to be written.
+     * @tparam T
+     */
+    template<class T>
+    struct Access
+    {
+        using Type = T;
+        static constexpr bool write = true;
+        static constexpr Filter filter = Filter::None;
+    };
+
+    template<class T>
+    struct Access<Read<T>>
+    {
+        using Type = T;
+        static constexpr bool write = false;
+        static constexpr Filter filter = Filter::None;
+    };
+
+    template<class T>
+    struct Access<Write<T>>
+    {
+        using Type = T;
+        static constexpr bool write = true;
+        static constexpr Filter filter = Filter::None;
+    };
+
+    template<class T>
+    struct Access<Changed<T>>
+    {
+        using Type = T;
+        static constexpr bool write = false;
+        static constexpr Filter filter = Filter::Changed;
+    };
+
+    template<class T>
+    struct Access<Added<T>>
+    {
+        using Type = T;
+        static constexpr bool write = false;
+        static constexpr Filter filter = Filter::Added;
+    };
+};
+
+#endif //ACCESS_HPP
@@ -0,0 +1,429 @@
+#ifndef ARCHETYPE_HPP
+#define ARCHETYPE_HPP
+
+#include <vector>
+#include <memory>
+#include <array>
+#include <cassert>
+#include <algorithm>
+
+#include "componentid.hpp"
+#include "entityid.hpp"
+#include "pool.hpp"
+#include "tick.hpp"
+
+namespace ecs
+{
+    /**
+     * Sorted set of component type ids
+     */
+    typedef std::vector<size_t> ComponentSet;
+
+    /**
+     * Type erased chunked array of components of one type.
+     * Rows of all columns of one archetype are kept in sync.
+     * Besides components column keeps ticks of the last change
+     * and of adding of component in each row.
+     */
+    class BaseColumn
+    {
+    public:
+        virtual ~BaseColumn() = default;
+
+        /**
+         * Append default constructed component
+         * @param tick - tick of adding
+         */
+        virtual void emplace(Tick tick) = 0;
+
+        /**
+         * Append component moved from row of other column with its ticks.
+         * Other column must hold the same component type.
+         * @param other
+         * @param row
+         */
+        virtual void moveFrom(BaseColumn &other, size_t row) = 0;
+
+        /**
+         * Remove row by moving the last element into it
+         * @param row
+         */
+        virtual void swapRemove(size_t row) = 0;
+
+        /**
+         * Destroy each component and give memory back to pool
+         */
+        virtual void clear() = 0;
+
+        /**
+         * Create empty column of the same component type
+         * @return
+         */
+        virtual std::unique_ptr<BaseColumn> cloneEmpty() const = 0;
+
+        virtual size_t size() const = 0;
+
+        /**
+         * Tick of the last change of row
+         * @param row
+         * @return
+         */
+        Tick getChangedTick(size_t row) const
+        {
+            return std::max(m_changed[row], m_chunkWritten[row / chunk_rows]);
+        }
+
+        Tick getAddedTick(size_t row) const
+        {
+            return m_added[row];
+        }
+
+        /**
+         * Tick of the last change of any row of chunk
+         * @param chunk
+         * @return
+         */
+        Tick getChunkChangedTick(size_t chunk) const
+        {
+            return m_chunkChanged[chunk];
+        }
+
+        void markChanged(size_t row, Tick tick)
+        {
+            m_changed[row] = tick;
+            raiseChunk(row / chunk_rows, tick);
+        }
+
+        void markAdded(size_t row, Tick tick)
+        {
+            m_added[row] = tick;
+        }
+
+        /**
+         * Mark each row of chunk as changed in O(1),
+         * e.g. when whole chunk was written by forEach()
+         * @param chunk
+         * @param tick
+         */
+        void markChunkChanged(size_t chunk, Tick tick)
+        {
+            m_chunkWritten[chunk] = tick;
+            raiseChunk(chunk, tick);
+        }
+
+    protected:
+        void pushTicks(Tick added, Tick changed)
+        {
+            if (m_added.size() % chunk_rows == 0) {
+                m_chunkWritten.push_back(0);
+                m_chunkChanged.push_back(0);
+            }
+            m_added.push_back(added);
+            m_changed.push_back(changed);
+            raiseChunk(m_chunkChanged.size() - 1, changed);
+        }
+
+        void pushTicks(const BaseColumn &other, size_t row)
+        {
+            pushTicks(other.getAddedTick(row), other.getChangedTick(row));
+        }
+
+        /**
+         * Move ticks of the last row to row. Chunk of row may be marked
+         * later than moved row was, so it may look changed, but
+         * change of moved row is never lost.
+         * @param row
+         */
+        void swapRemoveTicks(size_t row)
+        {
+            const size_t last = m_added.size() - 1;
+            m_added[row] = m_added[last];
+            m_changed[row] = getChangedTick(last);
+            raiseChunk(row / chunk_rows, m_changed[row]);
+            m_added.pop_back();
+            m_changed.pop_back();
+
+            if (m_added.size() % chunk_rows == 0) {
+                m_chunkWritten.pop_back();
+                m_chunkChanged.pop_back();
+            }
+        }
+
+        // Capacity is kept by clear(), so refilled column doesn't allocate
+        void clearTicks()
+        {
+            m_added.clear();
+            m_changed.clear();
+            m_chunkWritten.clear();
+            m_chunkChanged.clear();
+        }
+
+    private:
+        void raiseChunk(size_t chunk, Tick tick)
+        {
+            m_chunkChanged[chunk] = std::max(m_chunkChanged[chunk], tick);
+        }
+
+        // Indexed by row
+        std::vector<Tick> m_added;
+        std::vector<Tick> m_changed;
+        // Indexed by chunk: tick of the last write of whole chunk
+        // and the maximal change tick of its rows
+        std::vector<Tick> m_chunkWritten;
+        std::vector<Tick> m_chunkChanged;
+    };
+
+    /**
+     * Column of components of one type. Components are kept in
+     * chunks of chunk_rows elements taken from ComponentPool,
+     * so growth of column never moves existing components.
+     * @tparam ComponentType
+     */
+    template<class ComponentType>
+    class Column : public BaseColumn
+    {
+    public:
+        explicit Column(ComponentPool<ComponentType> &pool) : m_pool(&pool)
+        {}
+
+        Column(const Column &) = delete;
+
+        Column &operator=(const Column &) = delete;
+
+        ~Column() override
+        {
+            clear();
+        }
+
+        void emplace(Tick tick) override
+        {
+            new(allocRow()) ComponentType();
+            pushTicks(tick, tick);
+            ++m_size;
+        }
+
+        void moveFrom(BaseColumn &other, size_t row) override
+        {
+            new(allocRow()) ComponentType(
+                    std::move(static_cast<Column<ComponentType> &>(other)[row]));
+            pushTicks(other, row);
+            ++m_size;
+        }
+
+        void swapRemove(size_t row) override
+        {
+            const size_t last = m_size - 1;
+            if (row != last)
+                (*this)[row] = std::move((*this)[last]);
+            (*this)[last].~ComponentType();
+            swapRemoveTicks(row);
+            --m_size;
+
+            if (m_size % chunk_rows == 0) {
+                m_pool->release(m_chunks.back());
+                m_chunks.pop_back();
+            }
+        }
+
+        void clear() override
+        {
+            for (size_t row = 0; row < m_size; ++row)
+                (*this)[row].~ComponentType();
+            for (ComponentType *chunk: m_chunks)
+                m_pool->release(chunk);
+
+            m_chunks.clear();
+            clearTicks();
+            m_size = 0;
+        }
+
+        std::unique_ptr<BaseColumn> cloneEmpty() const override
+        {
+            return std::make_unique<Column<ComponentType>>(*m_pool);
+        }
+
+        size_t size() const override
+        {
+            return m_size;
+        }
+
+        ComponentType &operator[](size_t row)
+        {
+            return m_chunks[row / chunk_rows][row % chunk_rows];
+        }
+
+        /**
+         * Get chunk by index. Chunk i holds rows
+         * [i * chunk_rows, (i + 1) * chunk_rows)
+         * @param idx
+         * @return
+         */
+        ComponentType *getChunk(size_t idx)
+        {
+            return m_chunks[idx];
+        }
+
+    private:
+        /**
+         * Get memory of row m_size, take new chunk if needed
+         * @return
+         */
+        ComponentType *allocRow()
+        {
+            if (m_size == m_chunks.size() * chunk_rows)
+                m_chunks.push_back(m_pool->acquire());
+
+            return &m_chunks.back()[m_size % chunk_rows];
+        }
+
+        ComponentPool<ComponentType> *m_pool;
+        std::vector<ComponentType *> m_chunks;
+        size_t m_size = 0;
+    };
+
+    /**
+     * Storage of all entities which have the same set of components.
+     * Components are stored as structure of arrays: one chunked
+     * column per component type, row i of each column belongs to the
+     * i'th entity of archetype.
+     */
+    class Archetype
+    {
+    public:
+        explicit Archetype(const Signature &signature) : m_signature(signature)
+        {
+            for (size_t type = 0; type < max_components; ++type)
+                if (signature.test(type))
+                    m_types.push_back(type);
+
+            m_columns.resize(m_types.empty() ? 0 : m_types.back() + 1);
+            addEdges.fill(nullptr);
+            removeEdges.fill(nullptr);
+        }
+
+        Archetype(const Archetype &) = delete;
+
+        Archetype &operator=(const Archetype &) = delete;
+
+        const Signature &getSignature() const
+        {
+            return m_signature;
+        }
+
+        /**
+         * Sorted ids of component types
+         * @return
+         */
+        const ComponentSet &getTypes() const
+        {
+            return m_types;
+        }
+
+        bool hasType(size_t type) const
+        {
+            return m_signature.test(type);
+        }
+
+        /**
+         * Check whether archetype holds each of types
+         * @param signature
+         * @return
+         */
+        bool hasTypes(const Signature &signature) const
+        {
+            return (m_signature & signature) == signature;
+        }
+
+        BaseColumn *getColumn(size_t type)
+        {
+            return type < m_columns.size() ? m_columns[type].get() : nullptr;
+        }
+
+        /**
+         * Get typed column or nullptr if archetype doesn't hold ComponentType
+         * @tparam ComponentType
+         * @return
+         */
+        template<class ComponentType>
+        Column<ComponentType> *getColumn()
+        {
+            return static_cast<Column<ComponentType> *>(
+                    getColumn(component_id<ComponentType>()));
+        }
+
+        void addColumn(size_t type, std::unique_ptr<BaseColumn> column)
+        {
+            assert(hasType(type) && "Archetype doesn't hold type of column");
+            m_columns[type] = std::move(column);
+        }
+
+        size_t size() const
+        {
+            return m_entities.size();
+        }
+
+        const std::vector<EntityId> &getEntities() const
+        {
+            return m_entities;
+        }
+
+        /**
+         * Register entity in new row. Components must be
+         * appended to each column by the caller.
+         * @param id
+         * @return row of entity
+         */
+        size_t pushEntity(EntityId id)
+        {
+            m_entities.push_back(id);
+            return m_entities.size() - 1;
+        }
+
+        /**
+         * Remove row from each column.
+         * @param row
+         * @return entity which was moved to row or null id if
+         * removed row was the last one
+         */
+        EntityId swapRemove(size_t row)
+        {
+            for (size_t type: m_types)
+                m_columns[type]->swapRemove(row);
+
+            EntityId moved;
+            if (row != m_entities.size() - 1) {
+                m_entities[row] = m_entities.back();
+                moved = m_entities[row];
+            }
+            m_entities.pop_back();
+
+            return moved;
+        }
+
+        /**
+         * Remove all entities, memory of columns goes back to pools
+         */
+        void clear()
+        {
+            for (size_t type: m_types)
+                m_columns[type]->clear();
+            m_entities.clear();
+        }
+
+        /**
+         * Cached transitions to neighbour archetypes indexed by
+         * component id, nullptr if transition wasn't cached yet
+         */
+        std::array<Archetype *, max_components> addEdges;
+        std::array<Archetype *, max_components> removeEdges;
+
+    private:
+        Signature m_signature;
+        ComponentSet m_types;
+        std::vector<EntityId> m_entities;
+        // Indexed by component id
+        std::vector<std::unique_ptr<BaseColumn>> m_columns;
+    };
+};
+
+#endif //ARCHETYPE_HPP
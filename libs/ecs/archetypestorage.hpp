@@ -0,0 +1,731 @@
+#ifndef ARCHETYPESTORAGE_HPP
+#define ARCHETYPESTORAGE_HPP
+
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include <array>
+#include <atomic>
+
+#include "entityid.hpp"
+#include "archetype.hpp"
+#include "pool.hpp"
+#include "threadpool.hpp"
+#include "query.hpp"
+#include "access.hpp"
+#include "tick.hpp"
+#include "robin_hood.h"
+
+namespace ecs
+{
+    /**
+     * Location of entity components. Slot is free when archetype is nullptr.
+     */
+    struct EntityRecord
+    {
+        Archetype *archetype = nullptr;
+        size_t row = 0;
+        uint32_t generation = 0;
+        bool active = false;
+    };
+
+    /**
+     * Rows [chunk * chunk_rows, chunk * chunk_rows + rows) of archetype
+     */
+    struct ChunkRange
+    {
+        Archetype *archetype;
+        size_t chunk;
+        size_t rows;
+    };
+
+    /**
+     * Owner of all entities, archetypes and queries over them.
+     * Entities live in dense slot array indexed by EntityId::index,
+     * freed slots are reused in LIFO order.
+     */
+    class ArchetypeStorage
+    {
+    public:
+        ArchetypeStorage()
+        {
+            m_archetypes.push_back(std::make_unique<Archetype>(Signature()));
+            m_index.emplace(Signature(), m_archetypes.back().get());
+        }
+
+        ArchetypeStorage(const ArchetypeStorage &) = delete;
+
+        ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+
+        /**
+         * Create entity without components
+         * @return
+         */
+        EntityId createEntity()
+        {
+            EntityId id;
+            if (!m_freeSlots.empty()) {
+                id.index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            } else {
+                id.index = m_records.size();
+                m_records.emplace_back();
+            }
+
+            EntityRecord &rec = m_records[id.index];
+            id.generation = rec.generation;
+            rec.archetype = getRoot();
+            rec.row = rec.archetype->pushEntity(id);
+            rec.active = false;
+
+            return id;
+        }
+
+        /**
+         * Destroy entity with all of its components.
+         * Each handle to it becomes invalid.
+         * @param id
+         */
+        void destroyEntity(EntityId id)
+        {
+            assert(isValid(id) && "Entity was already destroyed");
+            EntityRecord &rec = m_records[id.index];
+            removeRow(rec);
+
+            rec.archetype = nullptr;
+            ++rec.generation;
+            m_freeSlots.push_back(id.index);
+        }
+
+        /**
+         * Mark entity as not alive. It will be destroyed by
+         * destroyKilled(), so killing is safe while systems iterate.
+         * May be called concurrently.
+         * @param id
+         */
+        void kill(EntityId id)
+        {
+            getRecord(id).active = false;
+            std::lock_guard lock(m_killedMutex);
+            m_killed.push_back(id);
+        }
+
+        /**
+         * Destroy entities killed since the last call
+         */
+        void destroyKilled()
+        {
+            std::lock_guard lock(m_killedMutex);
+            for (EntityId id: m_killed)
+                if (isValid(id))
+                    destroyEntity(id);
+            m_killed.clear();
+        }
+
+        /**
+         * Check that id refers to existing entity
+         * @param id
+         * @return
+         */
+        bool isValid(EntityId id) const
+        {
+            return id.index < m_records.size()
+                   && m_records[id.index].generation == id.generation
+                   && m_records[id.index].archetype;
+        }
+
+        EntityRecord &getRecord(EntityId id)
+        {
+            assert(isValid(id) && "Access to destroyed entity");
+            return m_records[id.index];
+        }
+
+        const EntityRecord &getRecord(EntityId id) const
+        {
+            assert(isValid(id) && "Access to destroyed entity");
+            return m_records[id.index];
+        }
+
+        /**
+         * Destroy all entities at once. Memory of components goes back
+         * to pools, archetypes and queries are kept, so populating
+         * storage again doesn't allocate. Each handle becomes invalid.
+         */
+        void clear()
+        {
+            for (auto &archetype: m_archetypes)
+                archetype->clear();
+
+            m_freeSlots.clear();
+            // Reversed, so slots are reused from the first one
+            for (size_t idx = m_records.size(); idx-- > 0;) {
+                EntityRecord &rec = m_records[idx];
+                if (rec.archetype) {
+                    rec.archetype = nullptr;
+                    ++rec.generation;
+                }
+                m_freeSlots.push_back(idx);
+            }
+        }
+
+        /**
+         * Number of existing entities
+         * @return
+         */
+        size_t size() const
+        {
+            return m_records.size() - m_freeSlots.size();
+        }
+
+        /**
+         * Get component of entity id or nullptr if entity doesn't have it
+         * @tparam ComponentType
+         * @param id
+         * @return
+         */
+        template<class ComponentType>
+        ComponentType *getComponent(EntityId id)
+        {
+            EntityRecord &rec = getRecord(id);
+            auto column = rec.archetype->getColumn<ComponentType>();
+            if (!column)
+                return nullptr;
+
+            return &(*column)[rec.row];
+        }
+
+        /**
+         * Add default constructed component to entity id. If entity
+         * already has ComponentType it will be reset.
+         * @tparam ComponentType
+         * @param id
+         * @return
+         */
+        template<class ComponentType>
+        ComponentType *addComponent(EntityId id)
+        {
+            if (ComponentType *comp = getComponent<ComponentType>(id)) {
+                *comp = ComponentType();
+                EntityRecord &rec = getRecord(id);
+                const Tick tick = getTick();
+                auto column = rec.archetype->getColumn<ComponentType>();
+                column->markChanged(rec.row, tick);
+                column->markAdded(rec.row, tick);
+                return comp;
+            }
+
+            EntityRecord &rec = getRecord(id);
+            moveTo(rec, id, getWith<ComponentType>(rec.archetype));
+            return getComponent<ComponentType>(id);
+        }
+
+        template<class ComponentType>
+        void removeComponent(EntityId id)
+        {
+            EntityRecord &rec = getRecord(id);
+            if (rec.archetype->hasType(component_id<ComponentType>()))
+                moveTo(rec, id, getWithout<ComponentType>(rec.archetype));
+        }
+
+        /**
+         * Mark ComponentType of entity id as changed at current tick.
+         * Must be called after component was modified through pointer
+         * from getComponent(), forEach() marks written components itself.
+         * @tparam ComponentType
+         * @param id
+         */
+        template<class ComponentType>
+        void markChanged(EntityId id)
+        {
+            EntityRecord &rec = getRecord(id);
+            if (auto column = rec.archetype->getColumn<ComponentType>())
+                column->markChanged(rec.row, getTick());
+        }
+
+        /**
+         * Check whether ComponentType of entity id was changed after tick since
+         * @tparam ComponentType
+         * @param id
+         * @param since
+         * @return false if entity doesn't have ComponentType
+         */
+        template<class ComponentType>
+        bool isChanged(EntityId id, Tick since) const
+        {
+            const EntityRecord &rec = getRecord(id);
+            auto column = rec.archetype->getColumn(component_id<ComponentType>());
+            return column && column->getChangedTick(rec.row) > since;
+        }
+
+        /**
+         * Check whether ComponentType was added to entity id after tick since
+         * @tparam ComponentType
+         * @param id
+         * @param since
+         * @return false if entity doesn't have ComponentType
+         */
+        template<class ComponentType>
+        bool isAdded(EntityId id, Tick since) const
+        {
+            const EntityRecord &rec = getRecord(id);
+            auto column = rec.archetype->getColumn(component_id<ComponentType>());
+            return column && column->getAddedTick(rec.row) > since;
+        }
+
+        /**
+         * Current tick. Changes made outside of systems are marked with it.
+         * @return
+         */
+        Tick getTick() const
+        {
+            return m_tick.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Take tick for update of system. Ticks taken later are greater,
+         * so changes made after update of system are newer than it.
+         * @return
+         */
+        Tick nextTick()
+        {
+            return m_tick.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Archetype without components. Each new entity starts here.
+         * @return
+         */
+        Archetype *getRoot()
+        {
+            return m_archetypes.front().get();
+        }
+
+        /**
+         * Return archetype which has components of src and ComponentType
+         * @tparam ComponentType
+         * @param src
+         * @return
+         */
+        template<class ComponentType>
+        Archetype *getWith(Archetype *src)
+        {
+            const size_t type = component_id<ComponentType>();
+            if (Archetype *dst = src->addEdges[type])
+                return dst;
+
+            Signature signature = src->getSignature();
+            signature.set(type);
+            Archetype *dst = find(signature);
+            if (!dst) {
+                dst = createArchetype(signature, *src);
+                dst->addColumn(type, std::make_unique<Column<ComponentType>>(
+                        getPool<ComponentType>()));
+            }
+
+            src->addEdges[type] = dst;
+            dst->removeEdges[type] = src;
+            return dst;
+        }
+
+        /**
+         * Return archetype which has components of src except ComponentType
+         * @tparam ComponentType
+         * @param src
+         * @return
+         */
+        template<class ComponentType>
+        Archetype *getWithout(Archetype *src)
+        {
+            const size_t type = component_id<ComponentType>();
+            if (Archetype *dst = src->removeEdges[type])
+                return dst;
+
+            Signature signature = src->getSignature();
+            signature.reset(type);
+            Archetype *dst = find(signature);
+            if (!dst)
+                dst = createArchetype(signature, *src);
+
+            src->removeEdges[type] = dst;
+            dst->addEdges[type] = src;
+            return dst;
+        }
+
+        /**
+         * Return persistent query over archetypes which hold each
+         * of ComponentTypes. After the first call it is a plain
+         * array lookup under mutex.
+         * @tparam ComponentTypes
+         * @return
+         */
+        template<class ...ComponentTypes>
+        Query &getQuery()
+        {
+            const size_t id = query_id<ComponentTypes...>();
+            std::lock_guard lock(m_queryMutex);
+            if (id >= m_queryCache.size())
+                m_queryCache.resize(id + 1, nullptr);
+
+            if (!m_queryCache[id])
+                m_queryCache[id] = &findQuery(make_signature<ComponentTypes...>());
+
+            return *m_queryCache[id];
+        }
+
+        /**
+         * Return persistent query over archetypes which hold each
+         * of types of signature
+         * @param signature
+         * @return
+         */
+        Query &getQuery(const Signature &signature)
+        {
+            std::lock_guard lock(m_queryMutex);
+            return findQuery(signature);
+        }
+
+        /**
+         * Call func(Components&...) for each entity which has all of
+         * components of Args. Components are fetched sequentially from
+         * columns. Each of Args is component type, optionally wrapped
+         * into Read<>, Write<>, Changed<> or Added<> (see access.hpp).
+         * Entities are skipped if component of Changed<> wasn't changed
+         * or of Added<> wasn't added after tick since. Written components
+         * (unwrapped or Write<>) of visited entities are marked changed at tick.
+         * @tparam Args
+         * @tparam Function
+         * @param func
+         * @param since
+         * @param tick
+         */
+        template<class ...Args, class Function>
+        void each(Function &&func, Tick since, Tick tick)
+        {
+            for (Archetype *archetype: getQuery<typename Access<Args>::Type...>().getArchetypes()) {
+                const size_t size = archetype->size();
+                for (size_t chunk = 0; chunk * chunk_rows < size; ++chunk)
+                    eachInChunk<Args...>({archetype, chunk,
+                                          std::min(chunk_rows, size - chunk * chunk_rows)},
+                                         func, since, tick);
+            }
+        }
+
+        /**
+         * each() over all entities, changes are marked at current tick
+         * @tparam Args
+         * @tparam Function
+         * @param func
+         */
+        template<class ...Args, class Function>
+        void each(Function &&func)
+        {
+            each<Args...>(std::forward<Function>(func), 0, getTick());
+        }
+
+        /**
+         * The same as each() but chunks of archetypes are processed
+         * concurrently on pool. func must be safe to call concurrently
+         * for different entities.
+         * @tparam Args
+         * @tparam Function
+         * @param pool
+         * @param func
+         * @param since
+         * @param tick
+         */
+        template<class ...Args, class Function>
+        void parallelEach(ThreadPool &pool, Function &&func, Tick since, Tick tick)
+        {
+            const std::vector<ChunkRange> ranges =
+                    getChunks(getQuery<typename Access<Args>::Type...>());
+
+            auto process = [&ranges, &func, since, tick](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    eachInChunk<Args...>(ranges[i], func, since, tick);
+            };
+
+            pool.parallelFor(ranges.size(), pool.getGrain(ranges.size()), process);
+        }
+
+        template<class ...Args, class Function>
+        void parallelEach(ThreadPool &pool, Function &&func)
+        {
+            parallelEach<Args...>(pool, std::forward<Function>(func), 0, getTick());
+        }
+
+        /**
+         * Split entities matched by query into chunks
+         * @param query
+         * @return
+         */
+        static std::vector<ChunkRange> getChunks(const Query &query)
+        {
+            std::vector<ChunkRange> ranges;
+            for (Archetype *archetype: query.getArchetypes()) {
+                const size_t size = archetype->size();
+                for (size_t chunk = 0; chunk * chunk_rows < size; ++chunk)
+                    ranges.push_back({archetype, chunk,
+                                      std::min(chunk_rows, size - chunk * chunk_rows)});
+            }
+
+            return ranges;
+        }
+
+        /**
+         * Get pool of ComponentType, create it if needed
+         * @tparam ComponentType
+         * @return
+         */
+        template<class ComponentType>
+        ComponentPool<ComponentType> &getPool()
+        {
+            const size_t type = component_id<ComponentType>();
+            if (!m_pools[type])
+                m_pools[type] = std::make_unique<ComponentPool<ComponentType>>();
+
+            return static_cast<ComponentPool<ComponentType> &>(*m_pools[type]);
+        }
+
+        /**
+         * Allocation counters of ComponentType pool
+         * @tparam ComponentType
+         * @return
+         */
+        template<class ComponentType>
+        PoolStats getPoolStats()
+        {
+            return getPool<ComponentType>().getStats();
+        }
+
+        /**
+         * Sum of allocation counters of all pools
+         * @return
+         */
+        PoolStats getPoolStats() const
+        {
+            PoolStats stats;
+            for (const auto &pool: m_pools)
+                if (pool)
+                    stats += pool->getStats();
+
+            return stats;
+        }
+
+        /**
+         * Return memory of free chunks of each pool to heap
+         */
+        void shrink()
+        {
+            for (auto &pool: m_pools)
+                if (pool)
+                    pool->shrink();
+        }
+
+        const std::vector<std::unique_ptr<Archetype>> &getArchetypes() const
+        {
+            return m_archetypes;
+        }
+
+    private:
+        /**
+         * Body of each() for rows of one chunk
+         */
+        template<class ...Args, class Function>
+        static void eachInChunk(const ChunkRange &range, Function &func, Tick since, Tick tick)
+        {
+            const size_t first = range.chunk * chunk_rows;
+            auto columns = std::make_tuple(
+                    range.archetype->getColumn<typename Access<Args>::Type>()...);
+            auto data = std::apply([&range](auto... column) {
+                return std::make_tuple(column->getChunk(range.chunk)...);
+            }, columns);
+
+            if constexpr (((Access<Args>::filter == Filter::None) && ...)) {
+                for (size_t i = 0; i < range.rows; ++i)
+                    std::apply([i, &func](auto... row) { func(row[i]...); }, data);
+
+                std::apply([&range, tick](auto... column) {
+                    (markChunkWritten<Args>(*column, range.chunk, tick), ...);
+                }, columns);
+            } else {
+                const bool skip = std::apply([&range, since](auto... column) {
+                    return (unchanged<Args>(*column, range.chunk, since) || ...);
+                }, columns);
+                if (skip)
+                    return;
+
+                for (size_t i = 0; i < range.rows; ++i) {
+                    const size_t row = first + i;
+                    const bool accepted = std::apply([row, since](auto... column) {
+                        return (accepts<Args>(*column, row, since) && ...);
+                    }, columns);
+                    if (!accepted)
+                        continue;
+
+                    std::apply([i, &func](auto... row) { func(row[i]...); }, data);
+                    std::apply([row, tick](auto... column) {
+                        (markRowWritten<Args>(*column, row, tick), ...);
+                    }, columns);
+                }
+            }
+        }
+
+        /**
+         * Check that Changed<> filter of Arg rejects each row of chunk
+         */
+        template<class Arg>
+        static bool unchanged(const BaseColumn &column, size_t chunk, Tick since)
+        {
+            if constexpr (Access<Arg>::filter == Filter::Changed)
+                return column.getChunkChangedTick(chunk) <= since;
+            else
+                return false;
+        }
+
+        /**
+         * Check filter of Arg on row of column
+         */
+        template<class Arg>
+        static bool accepts(const BaseColumn &column, size_t row, Tick since)
+        {
+            if constexpr (Access<Arg>::filter == Filter::Changed)
+                return column.getChangedTick(row) > since;
+            else if constexpr (Access<Arg>::filter == Filter::Added)
+                return column.getAddedTick(row) > since;
+            else
+                return true;
+        }
+
+        /**
+         * Mark row as changed if Arg is written
+         */
+        template<class Arg>
+        static void markRowWritten(BaseColumn &column, size_t row, Tick tick)
+        {
+            if constexpr (Access<Arg>::write)
+                column.markChanged(row, tick);
+        }
+
+        /**
+         * Mark each row of chunk as changed if Arg is written
+         */
+        template<class Arg>
+        static void markChunkWritten(BaseColumn &column, size_t chunk, Tick tick)
+        {
+            if constexpr (Access<Arg>::write)
+                column.markChunkChanged(chunk, tick);
+        }
+
+        /**
+         * Find or create query, m_queryMutex must be locked
+         * @param types
+         * @return
+         */
+        Query &findQuery(const Signature &signature)
+        {
+            if (auto it = m_queries.find(signature); it != m_queries.end())
+                return *it->second;
+
+            auto query = std::make_unique<Query>(signature);
+            for (auto &archetype: m_archetypes)
+                query->tryAdd(archetype.get());
+
+            Query &res = *query;
+            m_queries.emplace(signature, std::move(query));
+            return res;
+        }
+
+        /**
+         * Move components of entity to archetype dst. Components which dst
+         * doesn't have are destroyed, new ones are default constructed.
+         * @param rec
+         * @param id
+         * @param dst
+         */
+        void moveTo(EntityRecord &rec, EntityId id, Archetype *dst)
+        {
+            Archetype *src = rec.archetype;
+            const size_t row = dst->pushEntity(id);
+            for (size_t type: dst->getTypes()) {
+                BaseColumn *column = dst->getColumn(type);
+                if (BaseColumn *srcColumn = src->getColumn(type))
+                    column->moveFrom(*srcColumn, rec.row);
+                else
+                    column->emplace(getTick());
+            }
+
+            removeRow(rec);
+            rec.archetype = dst;
+            rec.row = row;
+        }
+
+        /**
+         * Remove row of rec from its archetype and fix
+         * row of entity which took its place
+         * @param rec
+         */
+        void removeRow(EntityRecord &rec)
+        {
+            EntityId moved = rec.archetype->swapRemove(rec.row);
+            if (!moved.isNull())
+                m_records[moved.index].row = rec.row;
+        }
+
+        Archetype *find(const Signature &signature)
+        {
+            auto it = m_index.find(signature);
+            return it == m_index.end() ? nullptr : it->second;
+        }
+
+        /**
+         * Create archetype with types of signature and register it in
+         * queries. Columns which present in neighbour are created here,
+         * the rest is up to caller.
+         * @param signature
+         * @param neighbour
+         * @return
+         */
+        Archetype *createArchetype(const Signature &signature, Archetype &neighbour)
+        {
+            auto archetype = std::make_unique<Archetype>(signature);
+            for (size_t type: archetype->getTypes())
+                if (BaseColumn *column = neighbour.getColumn(type))
+                    archetype->addColumn(type, column->cloneEmpty());
+
+            for (auto &[types, query]: m_queries)
+                query->tryAdd(archetype.get());
+
+            m_archetypes.push_back(std::move(archetype));
+            m_index.emplace(signature, m_archetypes.back().get());
+            return m_archetypes.back().get();
+        }
+
+        // Declared before archetypes: columns give chunks back on destruction
+        // Indexed by component id
+        std::array<std::unique_ptr<BasePool>, max_components> m_pools;
+
+        std::vector<EntityRecord> m_records;
+        std::vector<uint32_t> m_freeSlots;
+        // Killed entities which wait for destruction
+        std::vector<EntityId> m_killed;
+        std::mutex m_killedMutex;
+
+        std::vector<std::unique_ptr<Archetype>> m_archetypes;
+        robin_hood::unordered_map<Signature, Archetype *, std::hash<Signature>> m_index;
+
+        robin_hood::unordered_map<Signature, std::unique_ptr<Query>,
+                std::hash<Signature>> m_queries;
+        // Indexed by query_id
+        std::vector<Query *> m_queryCache;
+        // Queries may be requested by concurrently updated systems
+        std::mutex m_queryMutex;
+
+        // Starts from 1, so each row is newer than tick 0
+        std::atomic<Tick> m_tick = 1;
+    };
+};
+
+#endif //ARCHETYPESTORAGE_HPP
@@ -1,6 +1,9 @@
 #ifndef BASESYSTEM_HPP
 #define BASESYSTEM_HPP
 
+#include "componentid.hpp"
+#include "tick.hpp"
+
 namespace ecs
 {
     class EcsManager;
@@ -21,10 +24,18 @@ namespace ecs
             m_ecsManager = ecs;
         }
 
-        virtual void update(size_t delta) final
+        /**
+         * @param delta
+         * @param tick - tick of this update, see ArchetypeStorage::nextTick()
+         */
+        virtual void update(size_t delta, Tick tick) final
         {
-            if (!m_stopped)
-                update_state(delta);
+            if (m_stopped)
+                return;
+
+            m_tick = tick;
+            update_state(delta);
+            m_lastRun = tick;
         }
 
         /**
@@ -43,11 +54,107 @@ namespace ecs
             m_stopped = false;
         }
 
+        /**
+         * Check whether systems can't run concurrently: one of
+         * them writes component which other one reads or writes.
+         * @param other
+         * @return
+         */
+        bool conflictsWith(const BaseSystem &other) const
+        {
+            return (m_writes & (other.m_writes | other.m_reads)).any()
+                   || (m_reads & other.m_writes).any();
+        }
+
+        /**
+         * System which must be updated on main thread,
+         * e.g. it uses OpenGL context or SDL
+         * @return
+         */
+        bool isMainThread() const
+        {
+            return m_mainThread;
+        }
+
+        /**
+         * Group of systems which are updated together,
+         * see EcsManager::updateSystems()
+         * @return
+         */
+        size_t getStage() const
+        {
+            return m_stage;
+        }
+
     protected:
         virtual void update_state(size_t delta) = 0;
 
+        /**
+         * Declare components which system reads besides its signature
+         * @tparam ComponentTypes
+         */
+        template<class ...ComponentTypes>
+        void reads()
+        {
+            m_reads |= make_signature<ComponentTypes...>();
+        }
+
+        /**
+         * Declare components which system writes besides its signature
+         * @tparam ComponentTypes
+         */
+        template<class ...ComponentTypes>
+        void writes()
+        {
+            m_writes |= make_signature<ComponentTypes...>();
+        }
+
+        void setMainThread()
+        {
+            m_mainThread = true;
+        }
+
+        /**
+         * Move system to other stage, e.g. rendering systems are updated
+         * once per frame while simulation ones on each fixed step.
+         * Must be called in constructor.
+         * @param stage
+         */
+        void setStage(size_t stage)
+        {
+            m_stage = stage;
+        }
+
+        /**
+         * Tick of the current update, components written by system are
+         * marked changed at it
+         * @return
+         */
+        Tick getTick() const
+        {
+            return m_tick;
+        }
+
+        /**
+         * Tick of the previous update or 0 if system wasn't updated yet.
+         * Changed<> and Added<> filters accept components changed after it.
+         * @return
+         */
+        Tick getLastRun() const
+        {
+            return m_lastRun;
+        }
+
         EcsManager *m_ecsManager;
         bool m_stopped;
+
+    private:
+        Signature m_reads;
+        Signature m_writes;
+        bool m_mainThread = false;
+        size_t m_stage = 0;
+        Tick m_tick = 0;
+        Tick m_lastRun = 0;
     };
 };
 
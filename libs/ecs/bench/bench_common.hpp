@@ -0,0 +1,61 @@
+#ifndef ECS_BENCH_COMMON_HPP
+#define ECS_BENCH_COMMON_HPP
+
+#include "ecs/ecsmanager.hpp"
+
+/**
+ * Components and world shared by benchmarks. Components mirror ones
+ * of MoonLander, components used by single benchmark are declared
+ * in it.
+ */
+
+struct PositionComponent : ecs::Component
+{
+    float x = 0.f;
+    float y = 0.f;
+    float angle = 0.f;
+};
+
+struct VelocityComponent : ecs::Component
+{
+    float x = 1.f;
+    float y = 1.f;
+    float angle = 0.f;
+};
+
+struct SpriteComponent : ecs::Component
+{
+    unsigned int idx = 0;
+    float clip[4] = {};
+};
+
+struct AnimationComponent : ecs::Component
+{
+    unsigned int cur_state = 0;
+};
+
+struct CollisionComponent : ecs::Component
+{
+    bool has_collision = false;
+};
+
+/**
+ * World without own logic: benchmark creates its systems and
+ * entities, update runs the systems
+ */
+class BenchWorld : public ecs::EcsManager
+{
+public:
+    explicit BenchWorld(size_t threads = 1) : ecs::EcsManager(threads)
+    {}
+
+    void init() override
+    {}
+
+    void update(size_t delta) override
+    {
+        updateSystems(delta);
+    }
+};
+
+#endif //ECS_BENCH_COMMON_HPP
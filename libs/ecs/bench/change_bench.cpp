@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "ecs/system.hpp"
+#include "bench_common.hpp"
+
+/**
+ * Systems which react on rare changes: each frame 1% of entities
+ * change state of animation, the rest are idle. Animation system
+ * either visits each entity or only changed ones through Changed<>
+ * filter, which skips chunks without changes at once.
+ * range(1) is stride of changed entities, with stride 100 changes
+ * are spread over each chunk.
+ */
+
+namespace
+{
+    class AnimateAllSystem : public ecs::System<ecs::Write<SpriteComponent>,
+            ecs::Read<AnimationComponent>>
+    {
+        void update_state(size_t delta) override
+        {
+            forEach<ecs::Write<SpriteComponent>, ecs::Read<AnimationComponent>>(
+                    [](SpriteComponent &sprite, const AnimationComponent &anim) {
+                        sprite.idx = anim.cur_state;
+                    });
+        }
+    };
+
+    class AnimateChangedSystem : public ecs::System<ecs::Write<SpriteComponent>,
+            ecs::Read<AnimationComponent>>
+    {
+        void update_state(size_t delta) override
+        {
+            forEach<ecs::Write<SpriteComponent>, ecs::Changed<AnimationComponent>>(
+                    [](SpriteComponent &sprite, const AnimationComponent &anim) {
+                        sprite.idx = anim.cur_state;
+                    });
+        }
+    };
+
+    template<class SystemType>
+    void animate(benchmark::State &state)
+    {
+        BenchWorld world;
+        world.createSystem<SystemType>();
+        std::vector<ecs::EntityId> ids;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            auto en = world.createEntity();
+            en.template addComponents<AnimationComponent, SpriteComponent>();
+            ids.push_back(en.getId());
+        }
+        world.update(0);
+
+        size_t frame = 0;
+        for (auto _: state) {
+            const size_t stride = state.range(1);
+            for (size_t i = 0; i < ids.size() / 100; ++i) {
+                auto en = world.getEntity(ids[i * stride]);
+                en.template getComponent<AnimationComponent>()->cur_state = frame;
+                en.template markChanged<AnimationComponent>();
+            }
+            world.update(0);
+            ++frame;
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+
+static void BM_AnimateAll(benchmark::State &state)
+{
+    animate<AnimateAllSystem>(state);
+}
+
+BENCHMARK(BM_AnimateAll)->ArgsProduct({{10000, 100000}, {1, 100}})->Unit(benchmark::kMicrosecond);
+
+static void BM_AnimateChanged(benchmark::State &state)
+{
+    animate<AnimateChangedSystem>(state);
+}
+
+BENCHMARK(BM_AnimateChanged)->ArgsProduct({{10000, 100000}, {1, 100}})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+/**
+ * Destruction of dead entities: kill list flushed by CommandBuffer
+ * against full scan of entities which was done each frame before.
+ * Each frame 1% of entities die and the same number is spawned.
+ */
+
+namespace
+{
+    class CommandWorld : public BenchWorld
+    {
+    public:
+        /**
+         * Destroy inactive entities the way World::filter_entities did
+         */
+        void filterEntities()
+        {
+            std::vector<ecs::EntityId> dead;
+            for (const auto &archetype: m_storage.getArchetypes())
+                for (auto id: archetype->getEntities())
+                    if (!m_storage.getRecord(id).active)
+                        dead.push_back(id);
+
+            for (auto id: dead)
+                destroyEntity(id);
+        }
+    };
+
+    std::vector<ecs::EntityId> populate(CommandWorld &world, size_t count)
+    {
+        std::vector<ecs::EntityId> ids;
+        for (size_t i = 0; i < count; ++i) {
+            auto en = world.createEntity();
+            en.addComponents<PositionComponent, VelocityComponent>();
+            en.activate();
+            ids.push_back(en.getId());
+        }
+
+        return ids;
+    }
+
+    /**
+     * Kill each 100th entity and record spawn of replacement
+     * @param world
+     * @param ids
+     * @param frame
+     */
+    void killAndSpawn(CommandWorld &world, std::vector<ecs::EntityId> &ids, size_t frame)
+    {
+        for (size_t i = frame % 100; i < ids.size(); i += 100) {
+            world.getEntity(ids[i]).kill();
+            world.getCommands().createEntity([&ids, i](ecs::Entity en) {
+                en.addComponents<PositionComponent, VelocityComponent>();
+                en.activate();
+                ids[i] = en.getId();
+            });
+        }
+    }
+}
+
+static void BM_KillList(benchmark::State &state)
+{
+    CommandWorld world;
+    auto ids = populate(world, state.range(0));
+
+    size_t frame = 0;
+    for (auto _: state) {
+        killAndSpawn(world, ids, frame++);
+        world.flushCommands();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 100);
+}
+
+BENCHMARK(BM_KillList)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_KillScan(benchmark::State &state)
+{
+    CommandWorld world;
+    auto ids = populate(world, state.range(0));
+
+    size_t frame = 0;
+    for (auto _: state) {
+        killAndSpawn(world, ids, frame++);
+        world.filterEntities();
+        world.flushCommands();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 100);
+}
+
+BENCHMARK(BM_KillScan)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
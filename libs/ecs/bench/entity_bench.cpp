@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "bench_common.hpp"
+
+/**
+ * Cost of single entity operations: creation and destruction
+ * throughput, latency of adding, removing and getting components.
+ * range(0) is number of entities, "latency" counter is seconds
+ * per operation.
+ */
+
+namespace
+{
+    std::vector<ecs::EntityId> populate(BenchWorld &world, size_t count)
+    {
+        std::vector<ecs::EntityId> ids;
+        ids.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto en = world.createEntity();
+            en.addComponents<PositionComponent, VelocityComponent>();
+            ids.push_back(en.getId());
+        }
+
+        return ids;
+    }
+
+    void setCounters(benchmark::State &state)
+    {
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.counters["latency"] = benchmark::Counter(
+                state.range(0), benchmark::Counter::kIsIterationInvariantRate
+                                | benchmark::Counter::kInvert);
+    }
+}
+
+/**
+ * Creation of entity with two components. Storage is cleared
+ * between iterations, so slots and chunks are reused.
+ */
+static void BM_CreateEntity(benchmark::State &state)
+{
+    BenchWorld world;
+    populate(world, state.range(0));
+
+    for (auto _: state) {
+        state.PauseTiming();
+        world.clearEntities();
+        state.ResumeTiming();
+
+        populate(world, state.range(0));
+    }
+
+    setCounters(state);
+}
+
+BENCHMARK(BM_CreateEntity)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Destruction of entities in order of creation
+ */
+static void BM_DestroyEntity(benchmark::State &state)
+{
+    BenchWorld world;
+    std::vector<ecs::EntityId> ids;
+
+    for (auto _: state) {
+        state.PauseTiming();
+        world.clearEntities();
+        ids = populate(world, state.range(0));
+        state.ResumeTiming();
+
+        for (auto id: ids)
+            world.destroyEntity(id);
+    }
+
+    setCounters(state);
+}
+
+BENCHMARK(BM_DestroyEntity)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Adding of one component: components of entity move to
+ * neighbour archetype through cached edge
+ */
+static void BM_AddComponent(benchmark::State &state)
+{
+    BenchWorld world;
+    const auto ids = populate(world, state.range(0));
+
+    for (auto _: state) {
+        for (auto id: ids)
+            benchmark::DoNotOptimize(world.getEntity(id).addComponent<SpriteComponent>());
+
+        state.PauseTiming();
+        for (auto id: ids)
+            world.getEntity(id).removeComponent<SpriteComponent>();
+        state.ResumeTiming();
+    }
+
+    setCounters(state);
+}
+
+BENCHMARK(BM_AddComponent)->RangeMultiplier(10)->Range(1000, 100000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Adding of several components at once by addComponents(),
+ * which walks type list by typeListReduce
+ */
+static void BM_AddComponents(benchmark::State &state)
+{
+    BenchWorld world;
+    const auto ids = populate(world, state.range(0));
+
+    for (auto _: state) {
+        for (auto id: ids)
+            world.getEntity(id).addComponents<SpriteComponent, CollisionComponent>();
+
+        state.PauseTiming();
+        for (auto id: ids) {
+            world.getEntity(id).removeComponent<SpriteComponent>();
+            world.getEntity(id).removeComponent<CollisionComponent>();
+        }
+        state.ResumeTiming();
+    }
+
+    setCounters(state);
+}
+
+BENCHMARK(BM_AddComponents)->RangeMultiplier(10)->Range(1000, 100000)
+        ->Unit(benchmark::kMicrosecond);
+
+static void BM_RemoveComponent(benchmark::State &state)
+{
+    BenchWorld world;
+    const auto ids = populate(world, state.range(0));
+
+    for (auto _: state) {
+        state.PauseTiming();
+        for (auto id: ids)
+            world.getEntity(id).addComponent<SpriteComponent>();
+        state.ResumeTiming();
+
+        for (auto id: ids)
+            world.getEntity(id).removeComponent<SpriteComponent>();
+    }
+
+    setCounters(state);
+}
+
+BENCHMARK(BM_RemoveComponent)->RangeMultiplier(10)->Range(1000, 100000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Random access to components by entity id: slot lookup, column
+ * lookup by component id and chunk indexing
+ */
+static void BM_GetComponent(benchmark::State &state)
+{
+    BenchWorld world;
+    const auto ids = populate(world, state.range(0));
+
+    for (auto _: state)
+        for (auto id: ids)
+            benchmark::DoNotOptimize(world.getEntity(id).getComponent<PositionComponent>());
+
+    setCounters(state);
+}
+
+BENCHMARK(BM_GetComponent)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
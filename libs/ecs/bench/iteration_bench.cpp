@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include "ecs/queryview.hpp"
+#include "bench_common.hpp"
+
+/**
+ * Iteration over queries at different number of entities.
+ * range(0) is number of entities which match query.
+ */
+
+namespace
+{
+    // Tags which split entities into 8 archetypes
+    struct RedTag : ecs::Component
+    {
+    };
+
+    struct BigTag : ecs::Component
+    {
+    };
+
+    struct StaticTag : ecs::Component
+    {
+    };
+
+    void populate(BenchWorld &world, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            world.createEntity().addComponents<PositionComponent, VelocityComponent>();
+    }
+
+    /**
+     * Create count entities of each combination of tags
+     * @param world
+     * @param count
+     */
+    void populateTagged(BenchWorld &world, size_t count)
+    {
+        for (size_t i = 0; i < count * 8; ++i) {
+            auto en = world.createEntity();
+            en.addComponents<PositionComponent, VelocityComponent>();
+            if (i & 1)
+                en.addComponent<RedTag>();
+            if (i & 2)
+                en.addComponent<BigTag>();
+            if (i & 4)
+                en.addComponent<StaticTag>();
+        }
+    }
+}
+
+/**
+ * Bulk update through columns
+ */
+static void BM_ForEach(benchmark::State &state)
+{
+    BenchWorld world;
+    populate(world, state.range(0));
+
+    for (auto _: state)
+        world.getStorage().each<ecs::Write<PositionComponent>, ecs::Read<VelocityComponent>>(
+                [](PositionComponent &pos, const VelocityComponent &vel) {
+                    pos.x += vel.x;
+                    pos.y += vel.y;
+                    pos.angle += vel.angle;
+                });
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ForEach)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * The same update through entity handles of QueryView
+ */
+static void BM_QueryView(benchmark::State &state)
+{
+    BenchWorld world;
+    populate(world, state.range(0));
+    auto &storage = world.getStorage();
+
+    for (auto _: state)
+        for (auto en: ecs::QueryView(storage,
+                                     storage.getQuery<PositionComponent, VelocityComponent>())) {
+            auto pos = en.getComponent<PositionComponent>();
+            auto vel = en.getComponent<VelocityComponent>();
+            pos->x += vel->x;
+            pos->y += vel->y;
+            pos->angle += vel->angle;
+        }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_QueryView)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Filtering by several tags like getEntitiesByTags(): query matches
+ * 2 of 8 archetypes, only matching entities are visited
+ */
+static void BM_MultiTagFilter(benchmark::State &state)
+{
+    BenchWorld world;
+    populateTagged(world, state.range(0) / 2);
+
+    for (auto _: state) {
+        float sum = 0.f;
+        world.getStorage().each<ecs::Read<PositionComponent>, ecs::Read<RedTag>,
+                ecs::Read<BigTag>>([&sum](const PositionComponent &pos, const RedTag &,
+                                          const BigTag &) { sum += pos.x; });
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_MultiTagFilter)->RangeMultiplier(10)->Range(1000, 1000000)
+        ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "ecs/system.hpp"
+#include "bench_common.hpp"
+
+/**
+ * Scaling of parallelForEach and parallelFor with number of threads.
+ * range(1) of each benchmark is total number of threads.
+ */
+
+namespace
+{
+    struct Position
+    {
+        float x = 0.f;
+        float y = 0.f;
+        float angle = 0.f;
+    };
+
+    /**
+     * Cloud of particles stored as array of structures
+     */
+    struct ParticleCloudComponent : ecs::Component
+    {
+        std::vector<Position> coords;
+        std::vector<Position> vel;
+    };
+
+    const size_t particle_grain = 4096;
+
+    class MovementSystem : public ecs::System<ecs::Write<PositionComponent>,
+            ecs::Read<VelocityComponent>, ecs::Write<ParticleCloudComponent>>
+    {
+        void update_state(size_t delta) override
+        {
+            parallelForEach<PositionComponent, VelocityComponent>(
+                    [](PositionComponent &pos, const VelocityComponent &vel) {
+                        pos.x += vel.x;
+                        pos.y += vel.y;
+                        pos.angle += vel.angle;
+                    });
+
+            forEach<ParticleCloudComponent>([this](ParticleCloudComponent &cloud) {
+                auto &coords = cloud.coords;
+                const auto &vel = cloud.vel;
+                parallelFor(coords.size(), particle_grain,
+                            [&coords, &vel](size_t begin, size_t end) {
+                                for (size_t i = begin; i < end; ++i) {
+                                    coords[i].x += vel[i].x;
+                                    coords[i].y += vel[i].y;
+                                    coords[i].angle += vel[i].angle;
+                                }
+                            });
+            });
+        }
+    };
+
+}
+
+static void BM_ParallelMovement(benchmark::State &state)
+{
+    BenchWorld world(state.range(1));
+    world.createSystem<MovementSystem>();
+    for (int64_t i = 0; i < state.range(0); ++i)
+        world.createEntity().addComponents<PositionComponent, VelocityComponent>();
+
+    for (auto _: state)
+        world.update(0);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ParallelMovement)->ArgsProduct({{1 << 20}, {1, 2, 4, 8, 16}})
+        ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/**
+ * Integration of few large particle clouds, e.g. explosions
+ */
+static void BM_ParticleClouds(benchmark::State &state)
+{
+    const size_t clouds = 16;
+    BenchWorld world(state.range(1));
+    world.createSystem<MovementSystem>();
+    for (size_t i = 0; i < clouds; ++i) {
+        auto cloud = world.createEntity().addComponent<ParticleCloudComponent>();
+        cloud->coords.resize(state.range(0));
+        cloud->vel.assign(state.range(0), {1.f, 1.f, 0.01f});
+    }
+
+    for (auto _: state)
+        world.update(0);
+
+    state.SetItemsProcessed(state.iterations() * clouds * state.range(0));
+}
+
+BENCHMARK(BM_ParticleClouds)->ArgsProduct({{1 << 16}, {1, 2, 4, 8, 16}})
+        ->Unit(benchmark::kMicrosecond)->UseRealTime();
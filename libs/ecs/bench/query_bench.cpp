@@ -0,0 +1,315 @@
+#include <benchmark/benchmark.h>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include "ecs/system.hpp"
+#include "bench_common.hpp"
+
+/**
+ * Frame cost of systems with the same component sets as systems
+ * of MoonLander. Each entity archetype mirrors game one, most of
+ * entities are debris which only have position and velocity.
+ */
+
+struct TextComponent : ecs::Component
+{
+    unsigned int texture = 0;
+};
+
+struct KeyboardComponent : ecs::Component
+{
+    int pressed = 0;
+};
+
+struct ParticleComponent : ecs::Component
+{
+    float life_time = 0.f;
+};
+
+class QueryWorld : public BenchWorld
+{
+public:
+    using BenchWorld::BenchWorld;
+
+    // Named entities as they were kept before generational handles
+    std::unordered_map<size_t, ecs::Entity> named;
+
+    size_t getLevels()
+    {
+        return m_scheduler.getLevels().size();
+    }
+};
+
+class RendererSystem : public ecs::System<ecs::Read<PositionComponent>,
+        ecs::Read<TextComponent>>
+{
+public:
+    RendererSystem()
+    {
+        reads<SpriteComponent>();
+        setMainThread();
+    }
+
+private:
+    void update_state(size_t delta) override
+    {
+        for (auto en: getEntitiesByTag<SpriteComponent>())
+            benchmark::DoNotOptimize(en.getComponent<PositionComponent>()->x);
+        for (auto en: getEntities())
+            benchmark::DoNotOptimize(en.getComponent<TextComponent>()->texture);
+    }
+};
+
+class MovementSystem : public ecs::System<ecs::Write<PositionComponent>,
+        ecs::Read<VelocityComponent>>
+{
+    void update_state(size_t delta) override
+    {
+        forEach<PositionComponent, VelocityComponent>(
+                [](PositionComponent &pos, const VelocityComponent &vel) {
+                    pos.x += vel.x;
+                    pos.y += vel.y;
+                });
+    }
+};
+
+class KeyboardSystem : public ecs::System<KeyboardComponent>
+{
+public:
+    KeyboardSystem()
+    {
+        setMainThread();
+    }
+
+private:
+    void update_state(size_t delta) override
+    {
+        for (auto en: getEntities())
+            en.getComponent<KeyboardComponent>()->pressed++;
+    }
+};
+
+class AnimationSystem : public ecs::System<ecs::Write<SpriteComponent>,
+        ecs::Read<AnimationComponent>>
+{
+    void update_state(size_t delta) override
+    {
+        for (auto en: getEntities())
+            en.getComponent<SpriteComponent>()->idx =
+                    en.getComponent<AnimationComponent>()->cur_state;
+    }
+};
+
+class CollisionSystem : public ecs::System<ecs::Write<CollisionComponent>,
+        ecs::Read<SpriteComponent>>
+{
+public:
+    CollisionSystem()
+    {
+        reads<PositionComponent>();
+    }
+
+private:
+    void update_state(size_t delta) override
+    {
+        for (auto en: getEntitiesByTags<SpriteComponent, CollisionComponent>())
+            en.getComponent<CollisionComponent>()->has_collision =
+                    en.getComponent<PositionComponent>()->y < 0.f;
+    }
+};
+
+class PhysicsSystem : public ecs::System<VelocityComponent>
+{
+    void update_state(size_t delta) override
+    {
+        forEach<VelocityComponent>([](VelocityComponent &vel) {
+            vel.y += 0.5f / 150.f;
+        });
+    }
+};
+
+class ParticleRenderSystem : public ecs::System<ecs::Read<ParticleComponent>>
+{
+public:
+    ParticleRenderSystem()
+    {
+        setMainThread();
+    }
+
+private:
+    void update_state(size_t delta) override
+    {
+        for (auto en: getEntities())
+            benchmark::DoNotOptimize(en.getComponent<ParticleComponent>()->life_time);
+    }
+};
+
+void spawn(QueryWorld &world, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        auto en = world.createEntity();
+        switch (i % 100) {
+            case 0: // ship
+                en.addComponents<PositionComponent, VelocityComponent,
+                        SpriteComponent, AnimationComponent, CollisionComponent,
+                        KeyboardComponent>();
+                break;
+            case 1: // hud
+                en.addComponents<PositionComponent, TextComponent>();
+                break;
+            case 2: // static sprites
+                en.addComponents<PositionComponent, SpriteComponent>();
+                break;
+            case 3: // particles
+                en.addComponents<ParticleComponent, VelocityComponent>();
+                break;
+            default: // debris
+                en.addComponents<PositionComponent, VelocityComponent>();
+        }
+        en.activate();
+    }
+}
+
+void populate(QueryWorld &world, size_t count)
+{
+    world.createSystem<RendererSystem>();
+    world.createSystem<MovementSystem>();
+    world.createSystem<KeyboardSystem>();
+    world.createSystem<AnimationSystem>();
+    world.createSystem<CollisionSystem>();
+    world.createSystem<PhysicsSystem>();
+    world.createSystem<ParticleRenderSystem>();
+
+    spawn(world, count);
+}
+
+static void BM_SystemsFrame(benchmark::State &state)
+{
+    QueryWorld world;
+    populate(world, state.range(0));
+
+    for (auto _: state)
+        world.update(0);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SystemsFrame)->Arg(1000)->Arg(10000)->Arg(100000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * The same frame updated by scheduler with range(1) threads
+ */
+static void BM_SystemsFrameThreads(benchmark::State &state)
+{
+    QueryWorld world(state.range(1));
+    populate(world, state.range(0));
+
+    for (auto _: state)
+        world.update(0);
+
+    state.counters["levels"] = world.getLevels();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SystemsFrameThreads)->ArgsProduct({{100000}, {1, 2, 4, 8, 16}})
+        ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+/**
+ * Filtering which was used before persistent queries: each system copied
+ * entities map and erased entities which don't match, every frame.
+ */
+template<class ...ComponentTypes>
+auto copyFilter(QueryWorld &world)
+{
+    auto filtered = world.named;
+    for (auto it = filtered.begin(); it != filtered.end();)
+        it = (it->second.template hasComponent<ComponentTypes>() && ...)
+             ? ++it : filtered.erase(it);
+
+    return filtered;
+}
+
+static void BM_SystemsFrameMapCopy(benchmark::State &state)
+{
+    QueryWorld world;
+    populate(world, state.range(0));
+    for (const auto &archetype: world.getStorage().getArchetypes())
+        for (auto id: archetype->getEntities())
+            world.named.emplace(id.index, world.getEntity(id));
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(copyFilter<SpriteComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<PositionComponent, TextComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<PositionComponent, VelocityComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<KeyboardComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<SpriteComponent, AnimationComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<SpriteComponent, CollisionComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<VelocityComponent>(world).size());
+        benchmark::DoNotOptimize(copyFilter<ParticleComponent>(world).size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SystemsFrameMapCopy)->Arg(1000)->Arg(10000)->Arg(100000)
+        ->Unit(benchmark::kMicrosecond);
+
+
+/**
+ * Spawn and destroy particle entities the way ship explosion does.
+ * Slots of destroyed entities are reused, so after the first
+ * iteration there are no allocations of entity records.
+ */
+static void BM_EntityChurn(benchmark::State &state)
+{
+    QueryWorld world;
+    std::vector<ecs::EntityId> ids(state.range(0));
+
+    for (auto _: state) {
+        for (auto &id: ids) {
+            auto en = world.createEntity();
+            en.addComponents<ParticleComponent, VelocityComponent>();
+            id = en.getId();
+        }
+        for (auto id: ids)
+            world.destroyEntity(id);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_EntityChurn)->Arg(1000)->Arg(10000)
+        ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Restart of world: all entities are destroyed at once and created
+ * again. Component memory is taken from pools, so after the first
+ * restart there must be no heap allocations.
+ */
+static void BM_WorldRestart(benchmark::State &state)
+{
+    QueryWorld world;
+    populate(world, state.range(0));
+    world.clearEntities();
+    spawn(world, state.range(0));
+
+    const size_t allocations = world.getStorage().getPoolStats().allocations;
+    for (auto _: state) {
+        world.clearEntities();
+        spawn(world, state.range(0));
+    }
+
+    const ecs::PoolStats stats = world.getStorage().getPoolStats();
+    if (stats.allocations != allocations)
+        state.SkipWithError("Restart allocated new chunks");
+
+    state.counters["chunks"] = stats.used;
+    state.counters["allocations"] = stats.allocations - allocations;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_WorldRestart)->Arg(1000)->Arg(10000)
+        ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,126 @@
+#ifndef COMMANDBUFFER_HPP
+#define COMMANDBUFFER_HPP
+
+#include <vector>
+#include <mutex>
+#include <functional>
+
+#include "entity.hpp"
+#include "archetypestorage.hpp"
+
+namespace ecs
+{
+    /**
+     * Deferred structural changes.
+     * Systems must not create and destroy entities or change their
+     * component sets while systems are updated, because other systems
+     * may iterate the same archetypes concurrently. Such changes are
+     * recorded here from any thread and applied in order of recording
+     * by flush() at one point of frame.
+     */
+    class CommandBuffer
+    {
+    public:
+        CommandBuffer() = default;
+
+        CommandBuffer(const CommandBuffer &) = delete;
+
+        CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+        /**
+         * Create entity on flush and pass it to init
+         * @param init
+         */
+        void createEntity(std::function<void(Entity)> init)
+        {
+            record([init = std::move(init)](ArchetypeStorage &storage) {
+                init(Entity(&storage, storage.createEntity()));
+            });
+        }
+
+        /**
+         * Destroy entity on flush if it still exists
+         * @param id
+         */
+        void destroyEntity(EntityId id)
+        {
+            record([id](ArchetypeStorage &storage) {
+                if (storage.isValid(id))
+                    storage.destroyEntity(id);
+            });
+        }
+
+        /**
+         * Add component to entity on flush
+         * @tparam ComponentType
+         * @param id
+         * @param component - value of new component
+         */
+        template<class ComponentType>
+        void addComponent(EntityId id, ComponentType component = ComponentType())
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "Template parameter class must be child of Component");
+
+            record([id, component = std::move(component)](ArchetypeStorage &storage) mutable {
+                if (storage.isValid(id))
+                    *storage.addComponent<ComponentType>(id) = std::move(component);
+            });
+        }
+
+        template<class ComponentType>
+        void removeComponent(EntityId id)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "Template parameter class must be child of Component");
+
+            record([id](ArchetypeStorage &storage) {
+                if (storage.isValid(id))
+                    storage.removeComponent<ComponentType>(id);
+            });
+        }
+
+        /**
+         * Apply recorded commands and entities killed since last flush.
+         * Must not be called while systems are updated.
+         * @param storage
+         */
+        void flush(ArchetypeStorage &storage)
+        {
+            std::vector<std::function<void(ArchetypeStorage &)>> commands;
+            {
+                std::lock_guard lock(m_mutex);
+                commands.swap(m_commands);
+            }
+
+            for (auto &command: commands)
+                command(storage);
+
+            storage.destroyKilled();
+
+            // Keep capacity for the next frame
+            commands.clear();
+            std::lock_guard lock(m_mutex);
+            if (m_commands.empty())
+                m_commands.swap(commands);
+        }
+
+        bool empty() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_commands.empty();
+        }
+
+    private:
+        void record(std::function<void(ArchetypeStorage &)> command)
+        {
+            std::lock_guard lock(m_mutex);
+            m_commands.push_back(std::move(command));
+        }
+
+        mutable std::mutex m_mutex;
+        std::vector<std::function<void(ArchetypeStorage &)>> m_commands;
+    };
+};
+
+#endif //COMMANDBUFFER_HPP
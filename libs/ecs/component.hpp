@@ -4,14 +4,14 @@
 namespace ecs
 {
     /**
-     * Base class for component
+     * Base class for component.
+     * Components are stored by value in archetype columns,
+     * so there is no virtual destructor here.
      */
     class Component
     {
     public:
         Component(){};
-
-        virtual ~Component() = default;
     };
 };
 
@@ -0,0 +1,65 @@
+#ifndef COMPONENTID_HPP
+#define COMPONENTID_HPP
+
+#include <bitset>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+namespace ecs
+{
+    /**
+     * Maximal number of component types, size of Signature
+     */
+    constexpr size_t max_components = 128;
+
+    /**
+     * Set of component types as bitmask indexed by component_id
+     */
+    typedef std::bitset<max_components> Signature;
+
+    inline std::atomic<size_t> component_id_seq = 0;
+
+    /**
+     * Dense id of component type in [0, max_components).
+     * Id is assigned on the first call, initialization of function
+     * local static is thread-safe and doesn't depend on order of
+     * static initialization, so id may be used by other static
+     * initializers. Ids are used as indexes of arrays and bits of
+     * Signature instead of keys of hash maps, so program is aborted
+     * by registration of more than max_components types, also
+     * in release build.
+     * @tparam ComponentType
+     * @return
+     */
+    template<class ComponentType>
+    size_t component_id() noexcept
+    {
+        static const size_t id = [] {
+            const size_t id = component_id_seq.fetch_add(1, std::memory_order_relaxed);
+            if (id >= max_components) {
+                std::fprintf(stderr, "ecs: too many component types, "
+                                     "max_components is %zu\n", max_components);
+                std::abort();
+            }
+            return id;
+        }();
+        return id;
+    }
+
+    /**
+     * Signature which has bits of each of ComponentTypes
+     * @tparam ComponentTypes
+     * @return
+     */
+    template<class ...ComponentTypes>
+    Signature make_signature() noexcept
+    {
+        Signature signature;
+        (signature.set(component_id<ComponentTypes>()), ...);
+        return signature;
+    }
+};
+
+#endif //COMPONENTID_HPP
@@ -2,9 +2,15 @@
 #define ECSMANAGER_HPP
 
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <cassert>
+#include <thread>
 
 #include "entity.hpp"
+#include "commandbuffer.hpp"
 #include "basesystem.hpp"
+#include "scheduler.hpp"
 
 namespace ecs
 {
@@ -16,6 +22,15 @@ namespace ecs
     class EcsManager
     {
     public:
+        /**
+         * @param threads - number of threads used to update systems
+         */
+        explicit EcsManager(size_t threads = std::thread::hardware_concurrency())
+                : m_scheduler(threads)
+        {}
+
+        virtual ~EcsManager() = default;
+
         /**
          * Create systems, etc...
          */
@@ -27,11 +42,54 @@ namespace ecs
          */
         virtual void update(size_t delta) = 0;
 
-        virtual std::shared_ptr<Entity> createEntity(size_t name)
+        /**
+         * Create new entity without components
+         * @return
+         */
+        virtual Entity createEntity()
+        {
+            return Entity(&m_storage, m_storage.createEntity());
+        }
+
+        /**
+         * Destroy entity and all of its components. Slot of entity
+         * will be reused, each handle to it becomes invalid.
+         * @param id
+         */
+        virtual void destroyEntity(EntityId id)
         {
-            std::shared_ptr ent = std::make_shared<Entity>();
-            m_entities.emplace(name, ent);
-            return m_entities[name];
+            m_storage.destroyEntity(id);
+        }
+
+        /**
+         * Destroy all entities at once. Memory of components is kept
+         * in pools and reused by entities created after.
+         */
+        virtual void clearEntities()
+        {
+            m_storage.clear();
+        }
+
+        /**
+         * Get entity handle by id. Id must be valid.
+         * @param id
+         * @return
+         */
+        Entity getEntity(EntityId id)
+        {
+            assert(m_storage.isValid(id) && "Access to destroyed entity");
+            return Entity(&m_storage, id);
+        }
+
+        /**
+         * Check that id refers to existing entity.
+         * Null and stale ids are invalid.
+         * @param id
+         * @return
+         */
+        bool isValid(EntityId id) const
+        {
+            return m_storage.isValid(id);
         }
 
         template<typename SystemType>
@@ -42,19 +100,60 @@ namespace ecs
 
             std::shared_ptr<SystemType> system(new SystemType());
             system->setEcsManager(this);
-            m_systems.insert({types::type_id<SystemType>,
-                              std::static_pointer_cast<BaseSystem>(system)});
+            if (m_systems.insert({types::type_id<SystemType>,
+                                  std::static_pointer_cast<BaseSystem>(system)}).second)
+                m_scheduler.add(system.get());
             return *system;
         }
 
-        virtual std::unordered_map<size_t, std::shared_ptr<Entity>> &getEntities()
+        /**
+         * Update each system of stage once. Systems without conflicting
+         * component access are updated concurrently, conflicting
+         * ones in order of creation.
+         * Systems must not create and destroy entities or change
+         * component sets directly, they record it to getCommands().
+         * @param delta
+         * @param stage - see BaseSystem::setStage()
+         */
+        void updateSystems(size_t delta, size_t stage = 0)
+        {
+            m_scheduler.run(delta, m_storage, stage);
+        }
+
+        /**
+         * Buffer of structural changes which are
+         * applied by flushCommands()
+         * @return
+         */
+        CommandBuffer &getCommands()
+        {
+            return m_commands;
+        }
+
+        /**
+         * Apply recorded structural changes and destroy killed
+         * entities. Call it once per frame outside of updateSystems().
+         */
+        void flushCommands()
+        {
+            m_commands.flush(m_storage);
+        }
+
+        ArchetypeStorage &getStorage()
+        {
+            return m_storage;
+        }
+
+        ThreadPool &getThreadPool()
         {
-            return m_entities;
+            return m_scheduler.getThreadPool();
         }
 
     protected:
-        std::unordered_map<size_t, std::shared_ptr<Entity>> m_entities;
+        ArchetypeStorage m_storage;
+        CommandBuffer m_commands;
         std::unordered_map<size_t, std::shared_ptr<BaseSystem>> m_systems;
+        Scheduler m_scheduler;
     };
 };
 
@@ -1,59 +1,65 @@
 #ifndef ENTITY_HPP
 #define ENTITY_HPP
 
-#include <memory>
-#include <unordered_map>
-
 #include "typelist.hpp"
 #include "component.hpp"
-#include "robin_hood.h"
+#include "entityid.hpp"
+#include "archetypestorage.hpp"
 
 namespace ecs
 {
-
-    typedef robin_hood::unordered_map<size_t, std::shared_ptr<Component>> ComponentMap;
-
     /**
      * Avoid circular including
      */
     class Component;
 
     /**
-     * Entity class
-     * Each entity may contain several unique components
+     * Entity handle.
+     * Each entity may contain several unique components.
+     * Components themselves are stored in archetype columns of
+     * ArchetypeStorage, handle only holds generational id, so it is
+     * cheap to copy and pass by value. Handle doesn't own entity:
+     * entity lives until EcsManager::destroyEntity is called.
      */
     class Entity
     {
     public:
-
-        Entity() : m_alive(false)
+        Entity() : m_storage(nullptr)
         {}
 
-        ~Entity()
-        {};
-
-        Entity(Entity &&en) = default;
-
-        Entity(Entity &en) = default;
+        Entity(ArchetypeStorage *storage, EntityId id)
+                : m_storage(storage), m_id(id)
+        {}
 
-        Entity &operator=(Entity &&) = default;
+        EntityId getId() const
+        {
+            return m_id;
+        }
 
-        Entity &operator=(const Entity &) = default;
+        /**
+         * Check that entity wasn't destroyed
+         * @return
+         */
+        bool isValid() const
+        {
+            return m_storage && m_storage->isValid(m_id);
+        }
 
         /**
          * Create new component and return it
-         * ComponentType must be child of Component class
+         * ComponentType must be child of Component class.
+         * Returned pointer valid until next change of component
+         * set of any entity with the same archetype.
          * @tparam ComponentType
          * @return
          */
         template<class ComponentType>
-        std::shared_ptr<Component> addComponent()
+        ComponentType *addComponent() const
         {
             static_assert(std::is_base_of_v<Component, ComponentType>,
                           "Template parameter class must be child of Component");
-            m_components[types::type_id<ComponentType>] =
-                    std::static_pointer_cast<Component>(std::make_shared<ComponentType>());
-            return m_components[types::type_id<ComponentType>];
+
+            return m_storage->addComponent<ComponentType>(m_id);
         }
 
         /**
@@ -63,7 +69,7 @@ namespace ecs
          * @return
          */
         template<class ...ComponentTypes>
-        void addComponents()
+        void addComponents() const
         {
             static_assert(types::IsBaseOfRec<Component, types::TypeList<ComponentTypes...>>::value,
                           "Template parameter class must be child of Component");
@@ -74,98 +80,136 @@ namespace ecs
             auto bin = [](auto x, auto y) { return 0; };
 
             auto un = [this](auto x) {
-                m_components[types::type_id<decltype(x)>] =
-                        std::static_pointer_cast<Component>(std::make_shared<decltype(x)>());
+                addComponent<decltype(x)>();
                 return 0;
             };
 
             types::typeListReduce<ComponentList>(un, bin);
         }
 
-
         /**
-         * Get component iterator by type
+         * Get component by type
          * @tparam ComponentType
-         * @return
+         * @return nullptr if entity doesn't have ComponentType
          */
         template<class ComponentType>
-        ComponentMap::iterator getComponentIt()
+        ComponentType *getComponent() const
         {
             static_assert(std::is_base_of_v<Component, ComponentType>,
                           "Template parameter class must be child of Component");
-            auto it = m_components.find(types::type_id<ComponentType>);
-            return it;
+
+            return m_storage->getComponent<ComponentType>(m_id);
         }
 
         /**
-         * Get component by type
+         * Get component by type or insert if doesn't exists.
          * @tparam ComponentType
          * @return
          */
         template<class ComponentType>
-        std::shared_ptr<ComponentType> getComponent()
+        ComponentType *getComponentNew() const
         {
             static_assert(std::is_base_of_v<Component, ComponentType>,
                           "Template parameter class must be child of Component");
 
-            const auto& it = m_components.find(types::type_id<ComponentType>);
-            if (it == m_components.end())
-                return std::shared_ptr<ComponentType>(nullptr);
+            if (ComponentType *comp = getComponent<ComponentType>())
+                return comp;
 
-            return std::dynamic_pointer_cast<ComponentType>(it->second);
+            return addComponent<ComponentType>();
         }
 
         /**
-         * Get component by type or insert if doesn't exists.
+         * Mark component as changed, so Changed<ComponentType>
+         * filters of systems accept entity. Call it after
+         * modification through getComponent() pointer.
          * @tparam ComponentType
+         */
+        template<class ComponentType>
+        void markChanged() const
+        {
+            m_storage->markChanged<ComponentType>(m_id);
+        }
+
+        /**
+         * Check whether component was changed after tick since
+         * @tparam ComponentType
+         * @param since
          * @return
          */
         template<class ComponentType>
-        std::shared_ptr<ComponentType> getComponentNew()
+        bool isChanged(Tick since) const
         {
-            static_assert(std::is_base_of_v<Component, ComponentType>,
-                          "Template parameter class must be child of Component");
+            return m_storage->isChanged<ComponentType>(m_id, since);
+        }
 
-            return std::dynamic_pointer_cast<ComponentType>(m_components[types::type_id<ComponentType>]);
+        /**
+         * Check whether component was added after tick since
+         * @tparam ComponentType
+         * @param since
+         * @return
+         */
+        template<class ComponentType>
+        bool isAdded(Tick since) const
+        {
+            return m_storage->isAdded<ComponentType>(m_id, since);
         }
 
         template<class ComponentType>
-        void removeComponent()
+        void removeComponent() const
         {
             static_assert(std::is_base_of_v<Component, ComponentType>,
                           "Template parameter class must be child of Component");
 
-            auto it = m_components.find(types::type_id<ComponentType>);
-            if (it != m_components.end())
-                m_components.erase(it);
+            m_storage->removeComponent<ComponentType>(m_id);
+        }
+
+        bool hasComponent(size_t type) const
+        {
+            return m_storage->getRecord(m_id).archetype->hasType(type);
+        }
+
+        template<class ComponentType>
+        bool hasComponent() const
+        {
+            return hasComponent(component_id<ComponentType>());
+        }
+
+        /**
+         * Bitmask of component types of entity
+         * @return
+         */
+        const Signature &getSignature() const
+        {
+            return m_storage->getRecord(m_id).archetype->getSignature();
         }
 
-        const ComponentMap& getComponents() const
+        const ComponentSet &getComponentTypes() const
         {
-            return m_components;
+            return m_storage->getRecord(m_id).archetype->getTypes();
         }
 
-        void activate()
+        void activate() const
         {
-            m_alive = true;
+            m_storage->getRecord(m_id).active = true;
         }
 
         bool isActivate() const
         {
-            return m_alive;
+            return m_storage->getRecord(m_id).active;
         }
 
         /**
-         * Set m_alive to false
+         * Mark entity as not alive. Entity is destroyed
+         * at the next flush of EcsManager.
          */
-        void kill()
+        void kill() const
         {
-            m_alive = false;
+            m_storage->kill(m_id);
         }
 
     private:
-        ComponentMap m_components;
-        bool m_alive;
+        ArchetypeStorage *m_storage;
+        EntityId m_id;
     };
 };
 
@@ -0,0 +1,56 @@
+#ifndef ENTITYID_HPP
+#define ENTITYID_HPP
+
+#include <cstdint>
+#include <limits>
+#include <functional>
+
+namespace ecs
+{
+    /**
+     * Generational entity handle.
+     * index - slot of entity in ArchetypeStorage
+     * generation - incremented each time slot is freed, so handles
+     * to destroyed entities can be detected even if slot was reused.
+     */
+    struct EntityId
+    {
+        uint32_t index = std::numeric_limits<uint32_t>::max();
+        uint32_t generation = 0;
+
+        constexpr bool operator==(const EntityId &other) const noexcept
+        {
+            return index == other.index && generation == other.generation;
+        }
+
+        constexpr bool operator!=(const EntityId &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+        /**
+         * Default constructed id never refers to entity
+         * @return
+         */
+        constexpr bool isNull() const noexcept
+        {
+            return index == std::numeric_limits<uint32_t>::max();
+        }
+
+        constexpr uint64_t value() const noexcept
+        {
+            return (static_cast<uint64_t>(generation) << 32u) | index;
+        }
+    };
+};
+
+template<>
+struct std::hash<ecs::EntityId>
+{
+    size_t operator()(const ecs::EntityId &id) const noexcept
+    {
+        return std::hash<uint64_t>()(id.value());
+    }
+};
+
+#endif //ENTITYID_HPP
@@ -0,0 +1,129 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <vector>
+#include <new>
+#include <cassert>
+
+namespace ecs
+{
+    /**
+     * Number of rows in one chunk of column.
+     * The same for all component types, so chunk i of each column
+     * of archetype holds components of the same entities.
+     * Must be power of two.
+     */
+    constexpr size_t chunk_rows = 256;
+
+    static_assert((chunk_rows & (chunk_rows - 1)) == 0,
+                  "chunk_rows must be power of two");
+
+    /**
+     * Allocation counters of pool.
+     * allocations - number of chunks ever requested from heap
+     * used - number of chunks currently owned by columns
+     * free - number of chunks ready to be reused without heap allocation
+     */
+    struct PoolStats
+    {
+        size_t allocations = 0;
+        size_t used = 0;
+        size_t free = 0;
+
+        PoolStats &operator+=(const PoolStats &other)
+        {
+            allocations += other.allocations;
+            used += other.used;
+            free += other.free;
+            return *this;
+        }
+    };
+
+    class BasePool
+    {
+    public:
+        virtual ~BasePool() = default;
+
+        virtual PoolStats getStats() const = 0;
+
+        /**
+         * Return free chunks to heap
+         */
+        virtual void shrink() = 0;
+    };
+
+    /**
+     * Pool of uninitialized chunks for components of one type.
+     * Columns take chunks when they grow and give them back when they
+     * shrink, so after warm up creation and destruction of entities
+     * doesn't touch heap. Memory is returned to heap only by shrink()
+     * and destructor.
+     * @tparam ComponentType
+     */
+    template<class ComponentType>
+    class ComponentPool : public BasePool
+    {
+    public:
+        ComponentPool() = default;
+
+        ComponentPool(const ComponentPool &) = delete;
+
+        ComponentPool &operator=(const ComponentPool &) = delete;
+
+        ~ComponentPool() override
+        {
+            assert(m_used == 0 && "Chunks of pool are still used by columns");
+            shrink();
+        }
+
+        /**
+         * Take chunk of chunk_rows uninitialized components
+         * @return
+         */
+        ComponentType *acquire()
+        {
+            ++m_used;
+            if (!m_free.empty()) {
+                ComponentType *chunk = m_free.back();
+                m_free.pop_back();
+                return chunk;
+            }
+
+            ++m_allocations;
+            return static_cast<ComponentType *>(::operator new(
+                    sizeof(ComponentType) * chunk_rows,
+                    std::align_val_t(alignof(ComponentType))));
+        }
+
+        /**
+         * Give chunk back to pool. Each component of chunk
+         * must be already destroyed.
+         * @param chunk
+         */
+        void release(ComponentType *chunk)
+        {
+            assert(m_used > 0 && "Chunk doesn't belong to pool");
+            --m_used;
+            m_free.push_back(chunk);
+        }
+
+        PoolStats getStats() const override
+        {
+            return {m_allocations, m_used, m_free.size()};
+        }
+
+        void shrink() override
+        {
+            for (ComponentType *chunk: m_free)
+                ::operator delete(chunk, std::align_val_t(alignof(ComponentType)));
+            m_free.clear();
+        }
+
+    private:
+        std::vector<ComponentType *> m_free;
+        size_t m_allocations = 0;
+        size_t m_used = 0;
+    };
+};
+
+#endif //POOL_HPP
@@ -0,0 +1,71 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include <atomic>
+#include <vector>
+
+#include "archetype.hpp"
+
+namespace ecs
+{
+    /**
+     * Persistent list of archetypes which hold each of query types.
+     * Query is registered in ArchetypeStorage and receives each new
+     * archetype, so matching is done once per archetype instead of
+     * once per entity per frame. Entities which change component set
+     * move between archetypes and thus are seen by query automatically.
+     */
+    class Query
+    {
+    public:
+        explicit Query(const Signature &signature) : m_signature(signature)
+        {}
+
+        Query(const Query &) = delete;
+
+        Query &operator=(const Query &) = delete;
+
+        /**
+         * Add archetype to matched list if it holds each of query types.
+         * Matching is single AND of signatures.
+         * @param archetype
+         */
+        void tryAdd(Archetype *archetype)
+        {
+            if (archetype->hasTypes(m_signature))
+                m_archetypes.push_back(archetype);
+        }
+
+        const Signature &getSignature() const
+        {
+            return m_signature;
+        }
+
+        const std::vector<Archetype *> &getArchetypes() const
+        {
+            return m_archetypes;
+        }
+
+    private:
+        Signature m_signature;
+        std::vector<Archetype *> m_archetypes;
+    };
+
+    inline std::atomic<size_t> query_id_seq = 0;
+
+    /**
+     * Unique id of each combination of component types, assigned on
+     * the first call the same way as component_id, so it may be used
+     * by static initializers. Used by systems to cache their queries.
+     * @tparam ComponentTypes
+     * @return
+     */
+    template<typename... ComponentTypes>
+    size_t query_id() noexcept
+    {
+        static const size_t id = query_id_seq.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+};
+
+#endif //QUERY_HPP
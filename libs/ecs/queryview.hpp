@@ -0,0 +1,160 @@
+#ifndef QUERYVIEW_HPP
+#define QUERYVIEW_HPP
+
+#include <vector>
+#include <iterator>
+
+#include "query.hpp"
+#include "entity.hpp"
+#include "threadpool.hpp"
+
+namespace ecs
+{
+    /**
+     * Lightweight range over entities matched by Query.
+     * Nothing is copied, iteration walks matched archetypes.
+     * View must not be used across structural changes (creation and
+     * destruction of entities, adding and removing components).
+     */
+    class QueryView
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Entity *;
+            using reference = Entity;
+
+            iterator(ArchetypeStorage *storage,
+                     const std::vector<Archetype *> *archetypes, size_t archetype,
+                     size_t row) : m_storage(storage), m_archetypes(archetypes),
+                                   m_archetype(archetype), m_row(row)
+            {
+                skipEmpty();
+            }
+
+            Entity operator*() const
+            {
+                return Entity(m_storage,
+                              (*m_archetypes)[m_archetype]->getEntities()[m_row]);
+            }
+
+            iterator &operator++()
+            {
+                ++m_row;
+                skipEmpty();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const iterator &other) const
+            {
+                return m_archetype == other.m_archetype && m_row == other.m_row;
+            }
+
+            bool operator!=(const iterator &other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+            /**
+             * Move to first row of next non empty archetype
+             * if current one is exhausted
+             */
+            void skipEmpty()
+            {
+                while (m_archetype < m_archetypes->size()
+                       && m_row >= (*m_archetypes)[m_archetype]->size()) {
+                    ++m_archetype;
+                    m_row = 0;
+                }
+            }
+
+            ArchetypeStorage *m_storage;
+            const std::vector<Archetype *> *m_archetypes;
+            size_t m_archetype;
+            size_t m_row;
+        };
+
+        QueryView(ArchetypeStorage &storage, const Query &query)
+                : m_storage(&storage), m_query(&query)
+        {}
+
+        iterator begin() const
+        {
+            return iterator(m_storage, &m_query->getArchetypes(), 0, 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(m_storage, &m_query->getArchetypes(),
+                            m_query->getArchetypes().size(), 0);
+        }
+
+        /**
+         * Number of matched entities. Complexity is linear of
+         * number of matched archetypes.
+         * @return
+         */
+        size_t size() const
+        {
+            size_t size = 0;
+            for (const Archetype *archetype: m_query->getArchetypes())
+                size += archetype->size();
+
+            return size;
+        }
+
+        bool empty() const
+        {
+            return begin() == end();
+        }
+
+        Entity front() const
+        {
+            return *begin();
+        }
+
+        /**
+         * Call func(Entity) for each matched entity, chunks of
+         * archetypes are processed concurrently on pool
+         * @tparam Function
+         * @param pool
+         * @param func
+         */
+        template<class Function>
+        void parallelForEach(ThreadPool &pool, Function &&func) const
+        {
+            const std::vector<ChunkRange> ranges = ArchetypeStorage::getChunks(*m_query);
+            ArchetypeStorage *storage = m_storage;
+
+            auto process = [&ranges, &func, storage](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const ChunkRange &range = ranges[i];
+                    const EntityId *ids = range.archetype->getEntities().data()
+                                          + range.chunk * chunk_rows;
+                    for (size_t row = 0; row < range.rows; ++row)
+                        func(Entity(storage, ids[row]));
+                }
+            };
+
+            pool.parallelFor(ranges.size(), pool.getGrain(ranges.size()), process);
+        }
+
+    private:
+        ArchetypeStorage *m_storage;
+        const Query *m_query;
+    };
+};
+
+#endif //QUERYVIEW_HPP
@@ -0,0 +1,140 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "basesystem.hpp"
+#include "threadpool.hpp"
+#include "archetypestorage.hpp"
+
+namespace ecs
+{
+    /**
+     * Runs systems in levels of dependency graph.
+     * System depends on each earlier registered system it conflicts
+     * with (see BaseSystem::conflictsWith), so conflicting systems are
+     * always updated in registration order. Systems of one level don't
+     * conflict and run concurrently, main thread systems are updated
+     * on the calling thread in registration order.
+     * Each stage (see BaseSystem::getStage()) has its own graph
+     * and is run separately.
+     */
+    class Scheduler
+    {
+    public:
+        typedef std::vector<std::vector<BaseSystem *>> Levels;
+
+        /**
+         * @param threads - total number of threads including calling one
+         */
+        explicit Scheduler(size_t threads) : m_pool(std::max<size_t>(threads, 1) - 1)
+        {}
+
+        void add(BaseSystem *system)
+        {
+            m_systems.push_back(system);
+            m_dirty = true;
+        }
+
+        /**
+         * Update each system of stage once.
+         * Each update gets its own tick of storage.
+         * @param delta
+         * @param storage
+         * @param stage
+         */
+        void run(size_t delta, ArchetypeStorage &storage, size_t stage = 0)
+        {
+            if (m_dirty)
+                build();
+
+            if (stage >= m_stages.size())
+                return;
+
+            for (const auto &level: m_stages[stage]) {
+                if (level.size() == 1 || m_pool.size() == 0) {
+                    for (BaseSystem *system: level)
+                        system->update(delta, storage.nextTick());
+                    continue;
+                }
+
+                TaskGroup group;
+                for (BaseSystem *system: level)
+                    if (!system->isMainThread())
+                        m_pool.submit(group, [system, delta, tick = storage.nextTick()] {
+                            system->update(delta, tick);
+                        });
+
+                try {
+                    for (BaseSystem *system: level)
+                        if (system->isMainThread())
+                            system->update(delta, storage.nextTick());
+                } catch (...) {
+                    m_pool.wait(group);
+                    throw;
+                }
+                m_pool.wait(group);
+            }
+        }
+
+        /**
+         * Pool which updates systems. Systems may use it
+         * for parallel processing of their entities.
+         * @return
+         */
+        ThreadPool &getThreadPool()
+        {
+            return m_pool;
+        }
+
+        /**
+         * Systems of stage grouped by levels of dependency graph
+         * @param stage
+         * @return
+         */
+        const Levels &getLevels(size_t stage = 0)
+        {
+            if (m_dirty)
+                build();
+
+            static const Levels empty;
+            return stage < m_stages.size() ? m_stages[stage] : empty;
+        }
+
+    private:
+        /**
+         * Level of system is one more than maximal level
+         * of earlier systems of the same stage it conflicts with
+         */
+        void build()
+        {
+            std::vector<size_t> depth(m_systems.size(), 0);
+            m_stages.clear();
+            for (size_t i = 0; i < m_systems.size(); ++i) {
+                const size_t stage = m_systems[i]->getStage();
+                for (size_t j = 0; j < i; ++j)
+                    if (m_systems[j]->getStage() == stage
+                        && m_systems[i]->conflictsWith(*m_systems[j]))
+                        depth[i] = std::max(depth[i], depth[j] + 1);
+
+                if (stage >= m_stages.size())
+                    m_stages.resize(stage + 1);
+                Levels &levels = m_stages[stage];
+                if (depth[i] >= levels.size())
+                    levels.resize(depth[i] + 1);
+                levels[depth[i]].push_back(m_systems[i]);
+            }
+
+            m_dirty = false;
+        }
+
+        std::vector<BaseSystem *> m_systems;
+        // Levels of each stage
+        std::vector<Levels> m_stages;
+        bool m_dirty = false;
+        ThreadPool m_pool;
+    };
+};
+
+#endif //SCHEDULER_HPP
@@ -2,13 +2,14 @@
 #define SYSTEM_HPP
 
 #include <vector>
-#include <set>
 #include <memory>
 
 #include "typelist.hpp"
 #include "basesystem.hpp"
 #include "entity.hpp"
 #include "ecsmanager.hpp"
+#include "queryview.hpp"
+#include "access.hpp"
 
 using ecs::types::typeListReduce;
 
@@ -16,37 +17,32 @@ namespace ecs
 {
     /**
      * Specialization
+     * Each of Args is component type, optionally wrapped into Read<> or
+     * Write<> to declare access of system. Unwrapped component is
+     * considered to be written. Scheduler of EcsManager runs systems
+     * without conflicting access concurrently.
      */
     template<typename ...Args>
     class System : public BaseSystem
     {
     public:
-        explicit System()
+        explicit System() : m_signature(make_signature<typename Access<Args>::Type...>())
         {
-            m_componentTypes.insert({types::type_id<Args>...});
+            (declareAccess<Args>(), ...);
         }
 
         virtual ~System() = default;
 
         /**
-         * Returns entities which corresponds to the componentTypes container filter
+         * Returns entities which have each component of system signature
          * @return
          */
-        auto getEntities() const
+        QueryView getEntities() const
         {
-            auto filtered = m_ecsManager->getEntities();
-            for (auto it = filtered.begin(); it != filtered.end();) {
-                auto components = it->second->getComponents();
-                if (std::any_of(m_componentTypes.begin(), m_componentTypes.end(),
-                                [&components](size_t t) {
-                                    return components.find(t) == components.end();
-                                }))
-                    it = filtered.erase(it);
-                else
-                    ++it;
-            }
-
-            return filtered;
+            if (!m_query)
+                m_query = &m_ecsManager->getStorage().getQuery(m_signature);
+
+            return QueryView(m_ecsManager->getStorage(), *m_query);
         }
 
         /**
@@ -55,7 +51,7 @@ namespace ecs
          * @return
          */
         template<typename... ComponentTypes>
-        auto getEntitiesByTags() const
+        QueryView getEntitiesByTags() const
         {
             static_assert(types::IsBaseOfRec<Component, types::TypeList<ComponentTypes...>>::value,
                           "Template parameter class must be child of Component");
@@ -63,22 +59,8 @@ namespace ecs
             static_assert(types::Length<ComponentList>::value >= 2,
                           "Length of ComponentTypes must be greeter than 2");
 
-            auto bin = [](bool x, bool y) { return x && y; };
-
-            auto filtered = m_ecsManager->getEntities();
-            for (auto it = filtered.begin(); it != filtered.end();) {
-                // Lambda to check that current entity (it) has
-                // each of ComponentTypes
-                auto un = [it](auto x) {
-                    return it->second->getComponent<decltype(x)>() != nullptr;
-                };
-                if (!typeListReduce<ComponentList>(un, bin))
-                    it = filtered.erase(it);
-                else
-                    ++it;
-            }
-
-            return filtered;
+            auto &storage = m_ecsManager->getStorage();
+            return QueryView(storage, storage.getQuery<ComponentTypes...>());
         }
 
         /**
@@ -87,24 +69,89 @@ namespace ecs
          * @return
          */
         template<class ComponentType>
-        auto getEntitiesByTag() const
+        QueryView getEntitiesByTag() const
         {
             static_assert(std::is_base_of_v<Component, ComponentType>,
                           "ComponentType class must be child of Component");
-            auto filtered = m_ecsManager->getEntities();
-            for (auto it = filtered.begin(); it != filtered.end();) {
-                if (!it->second->getComponent<ComponentType>())
-                    it = filtered.erase(it);
-                else
-                    ++it;
-            }
-
-            return filtered;
+
+            auto &storage = m_ecsManager->getStorage();
+            return QueryView(storage, storage.getQuery<ComponentType>());
+        }
+
+        /**
+         * Structural changes made during update must be recorded here
+         * @return
+         */
+        CommandBuffer &getCommands() const
+        {
+            return m_ecsManager->getCommands();
+        }
+
+        /**
+         * Call func(Components&...) for each entity which has all
+         * components of ComponentTypes. Walks archetype columns directly,
+         * so it is the fastest way to process components in bulk.
+         * Each of ComponentTypes may be wrapped into Read<> or Write<>, written
+         * components are marked changed. Changed<T> and Added<T> skip
+         * entities whose T wasn't changed or added since the previous
+         * update of system:
+         * forEach<Write<SpriteComponent>, Changed<AnimationComponent>>(...)
+         * @tparam ComponentTypes
+         * @tparam Function
+         * @param func
+         */
+        template<class ...ComponentTypes, class Function>
+        void forEach(Function &&func) const
+        {
+            m_ecsManager->getStorage().template each<ComponentTypes...>(
+                    std::forward<Function>(func), getLastRun(), getTick());
+        }
+
+        /**
+         * The same as forEach() but entities are processed concurrently
+         * on thread pool of ecs manager. func must not change state
+         * shared between entities.
+         * @tparam ComponentTypes
+         * @tparam Function
+         * @param func
+         */
+        template<class ...ComponentTypes, class Function>
+        void parallelForEach(Function &&func) const
+        {
+            m_ecsManager->getStorage().template parallelEach<ComponentTypes...>(
+                    m_ecsManager->getThreadPool(), std::forward<Function>(func),
+                    getLastRun(), getTick());
+        }
+
+        /**
+         * Call func(begin, end) for subranges of [0, count)
+         * concurrently, e.g. for particles of one component
+         * @tparam Function
+         * @param count
+         * @param grain - length of subrange
+         * @param func
+         */
+        template<class Function>
+        void parallelFor(size_t count, size_t grain, Function &&func) const
+        {
+            m_ecsManager->getThreadPool().parallelFor(count, grain,
+                                                      std::forward<Function>(func));
         }
 
     private:
-        // Contains id's of each component type system can handle
-        std::set<size_t> m_componentTypes;
+        template<class Arg>
+        void declareAccess()
+        {
+            if constexpr (Access<Arg>::write)
+                writes<typename Access<Arg>::Type>();
+            else
+                reads<typename Access<Arg>::Type>();
+        }
+
+        // Bits of each component type system can handle
+        Signature m_signature;
+        // Created on first use because ecs manager isn't known in constructor
+        mutable Query *m_query = nullptr;
     };
 };
 
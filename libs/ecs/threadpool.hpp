@@ -0,0 +1,281 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <utility>
+
+namespace ecs
+{
+    /**
+     * Set of tasks which can be waited for.
+     * Group must outlive each of its tasks.
+     */
+    class TaskGroup
+    {
+    public:
+        TaskGroup() = default;
+
+        TaskGroup(const TaskGroup &) = delete;
+
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        bool isDone() const
+        {
+            return m_pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        friend class ThreadPool;
+
+        std::atomic<size_t> m_pending = 0;
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    };
+
+    /**
+     * Work stealing thread pool.
+     * Each worker has its own deque: it takes tasks from the back of
+     * it and steals from the front of deques of other workers when its
+     * own one is empty. Threads which aren't workers push tasks to
+     * separate shared deque. Thread which waits for TaskGroup executes
+     * tasks too, so tasks may submit and wait for nested tasks, and
+     * pool without workers executes each task in wait().
+     */
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t workers)
+        {
+            // The last queue is shared by threads which aren't workers
+            for (size_t i = 0; i <= workers; ++i)
+                m_queues.push_back(std::make_unique<Queue>());
+
+            m_workers.reserve(workers);
+            for (size_t i = 0; i < workers; ++i)
+                m_workers.emplace_back([this, i] { work(i); });
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock(m_sleepMutex);
+                m_stop = true;
+            }
+            m_taskReady.notify_all();
+            for (auto &worker: m_workers)
+                worker.join();
+        }
+
+        /**
+         * Number of worker threads
+         * @return
+         */
+        size_t size() const
+        {
+            return m_workers.size();
+        }
+
+        void submit(TaskGroup &group, std::function<void()> task)
+        {
+            group.m_pending.fetch_add(1, std::memory_order_relaxed);
+            // Counted before task is visible, so thief which takes it
+            // can't decrement counter below zero
+            m_queued.fetch_add(1);
+
+            Queue &queue = *m_queues[currentQueue()];
+            {
+                std::lock_guard lock(queue.mutex);
+                queue.tasks.push_back({std::move(task), &group});
+            }
+
+            // Either sleeping worker sees counter above or it is counted
+            // as sleeper here, then mutex is taken only to wake it
+            if (m_sleeping.load() > 0) {
+                {
+                    std::lock_guard lock(m_sleepMutex);
+                }
+                m_taskReady.notify_one();
+            }
+        }
+
+        /**
+         * Execute tasks until each task of group is finished.
+         * The first exception thrown by task of group is rethrown here.
+         * @param group
+         */
+        void wait(TaskGroup &group)
+        {
+            const size_t queue = currentQueue();
+            while (!group.isDone())
+                if (!tryRun(queue))
+                    std::this_thread::yield();
+
+            if (group.m_error)
+                std::rethrow_exception(std::exchange(group.m_error, nullptr));
+        }
+
+        /**
+         * Call func(begin, end) for subranges of [0, count) of grain
+         * length, subranges are processed concurrently.
+         * @tparam Function
+         * @param count
+         * @param grain - length of subrange, count <= grain is
+         * processed on calling thread
+         * @param func
+         */
+        template<class Function>
+        void parallelFor(size_t count, size_t grain, Function &&func)
+        {
+            grain = std::max<size_t>(grain, 1);
+            if (m_workers.empty() || count <= grain) {
+                if (count > 0)
+                    func(size_t(0), count);
+                return;
+            }
+
+            TaskGroup group;
+            for (size_t begin = grain; begin < count; begin += grain) {
+                const size_t end = std::min(count, begin + grain);
+                submit(group, [&func, begin, end] { func(begin, end); });
+            }
+
+            try {
+                func(size_t(0), grain);
+            } catch (...) {
+                // Other tasks refer to func, so they must be finished first
+                wait(group);
+                throw;
+            }
+            wait(group);
+        }
+
+        /**
+         * Grain which splits count items into a few subranges per
+         * thread: enough to balance load by stealing, but not so many
+         * that scheduling of tasks dominates
+         * @param count
+         * @return
+         */
+        size_t getGrain(size_t count) const
+        {
+            const size_t tasksPerThread = 4;
+            return count / ((m_workers.size() + 1) * tasksPerThread) + 1;
+        }
+
+    private:
+        struct Task
+        {
+            std::function<void()> func;
+            TaskGroup *group = nullptr;
+        };
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void work(size_t idx)
+        {
+            t_pool = this;
+            t_queue = idx;
+            while (true) {
+                if (tryRun(idx))
+                    continue;
+
+                std::unique_lock lock(m_sleepMutex);
+                m_sleeping.fetch_add(1);
+                m_taskReady.wait(lock, [this] { return m_stop || m_queued.load() > 0; });
+                m_sleeping.fetch_sub(1);
+                if (m_stop)
+                    return;
+            }
+        }
+
+        /**
+         * Queue of calling thread
+         * @return
+         */
+        size_t currentQueue() const
+        {
+            return t_pool == this ? t_queue : m_workers.size();
+        }
+
+        /**
+         * Take task from back of own queue or steal it from
+         * front of other queue and execute it
+         * @param own
+         * @return false if there are no tasks
+         */
+        bool tryRun(size_t own)
+        {
+            Task task;
+            bool found = pop(*m_queues[own], task, true);
+            for (size_t i = 1; !found && i < m_queues.size(); ++i)
+                found = pop(*m_queues[(own + i) % m_queues.size()], task, false);
+
+            if (!found)
+                return false;
+
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+            try {
+                task.func();
+            } catch (...) {
+                std::lock_guard lock(task.group->m_errorMutex);
+                if (!task.group->m_error)
+                    task.group->m_error = std::current_exception();
+            }
+            task.group->m_pending.fetch_sub(1, std::memory_order_release);
+
+            return true;
+        }
+
+        static bool pop(Queue &queue, Task &task, bool back)
+        {
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty())
+                return false;
+
+            if (back) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            return true;
+        }
+
+        static inline thread_local ThreadPool *t_pool = nullptr;
+        static inline thread_local size_t t_queue = 0;
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        // Guards only sleep of workers and m_stop, queues have own locks
+        std::mutex m_sleepMutex;
+        std::condition_variable m_taskReady;
+        // Tasks submitted and not taken yet, and workers which are
+        // about to sleep or sleep. Both are sequentially consistent,
+        // so submit doesn't miss worker which goes to sleep.
+        std::atomic<size_t> m_queued = 0;
+        std::atomic<size_t> m_sleeping = 0;
+        bool m_stop = false;
+    };
+};
+
+#endif //THREADPOOL_HPP
@@ -0,0 +1,20 @@
+#ifndef TICK_HPP
+#define TICK_HPP
+
+#include <cstdint>
+
+namespace ecs
+{
+    /**
+     * Logical time of ArchetypeStorage. Each update of system gets
+     * its own tick, rows of columns remember ticks of their last
+     * change and of adding of component, so systems can skip data
+     * which wasn't changed since their previous update.
+     * Ticks are compared by plain < and >, so they must not wrap:
+     * 64 bits don't at any rate of updates, while 32 bits would
+     * in weeks at a thousand updates of systems per second.
+     */
+    typedef uint64_t Tick;
+};
+
+#endif //TICK_HPP
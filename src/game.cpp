@@ -129,20 +129,39 @@ void Game::initOnceSDL2()
 }
 
 
-Game::Game() : vsync_supported(false)
+Game::Game() : vsync_supported(false),
+               m_clock(sim_tick_rate, max_catch_up_steps)
 {
     m_glcontext = nullptr;
     m_window = nullptr;
 }
 
-void Game::update(size_t delta)
+void Game::update(size_t elapsed)
 {
-    if (getGameState() == GameStates::NEED_REPLAY) {
-        m_world.init(); // Reinit world
-        setGameState(GameStates::NORMAL);
+    const size_t steps = m_clock.advance(elapsed);
+    for (size_t i = 0; i < steps; ++i) {
+        if (getGameState() == GameStates::NEED_REPLAY) {
+            m_world.init(); // Reinit world
+            setGameState(GameStates::NORMAL);
+        }
+
+        m_world.update(m_clock.getStep());
     }
 
-    m_world.update(delta);
+    m_world.render(m_clock.getAlpha(), m_clock.getStep());
+}
+
+void Game::setTickRate(size_t tickRate)
+{
+    if (tickRate == 0)
+        throw std::invalid_argument("Tick rate must be positive");
+
+    m_clock.setTickRate(tickRate);
+}
+
+void Game::setSeed(std::uint64_t seed) noexcept
+{
+    m_world.setSeed(seed);
 }
 
 void Game::initGL()
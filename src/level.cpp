@@ -1,153 +1,153 @@
+#include <algorithm>
+
 #include "utils/random.hpp"
-#include "utils/math.hpp"
 #include "level.hpp"
 
 const GLfloat frame_width = 2000;
 
-const int stars_initial_size = 5000;
 const int points_initial_size = 500;
 const GLfloat deviation = 20.f;
+const GLfloat point_dist_min = frame_width / points_initial_size * 7.f;
+const GLfloat point_dist_max = frame_width / points_initial_size * 9.f;
+
+const int stars_per_line = 20;
+
+// Independent random sequences of chunk, so e.g. number of stars
+// doesn't change surface
+enum ChunkStream : std::uint64_t
+{
+    border_stream,
+    lines_stream,
+    surface_stream,
+    platforms_stream,
+    stars_stream
+};
 
 using glm::vec2;
-using utils::math::rotate_points;
+using utils::CounterRandom;
 
 Level::~Level()
 {
 }
 
-template <typename BidirectionalIterator>
-std::vector<vec2> generate_stars(BidirectionalIterator left,
-                                 BidirectionalIterator right, GLfloat gap = 0)
+/**
+ * Generate stars above each line of points
+ * @param points
+ * @param rand
+ * @return
+ */
+static std::vector<vec2> generate_stars(const std::vector<vec2>& points,
+                                        CounterRandom rand)
 {
-    utils::Random rand;
     std::vector<vec2> stars;
-    size_t size = std::distance(left, right);
-    size_t line_count = size / 2;
-    for (auto it = left; it != right - 1; ++it) {
+    stars.reserve((points.size() - 1) * stars_per_line);
+    for (auto it = points.cbegin(); it + 1 != points.cend(); ++it) {
         GLfloat lower = std::max((it + 1)->y, it->y);
         GLfloat higher = std::min((it + 1)->y, it->y);
-        for (size_t j = 0; j < stars_initial_size / line_count; ++j)
+        for (size_t j = 0; j < stars_per_line; ++j)
             stars.emplace_back(rand.generateu(it->x, (it + 1)->x),
-                               rand.generateu(lower - gap, higher - gap - frame_width));
+                               rand.generateu(higher - frame_width, lower));
     }
 
     return stars;
 }
 
 /**
- * Generate stars with x coordinate in range {left, right}
+ * Generate x coordinates of points in range [left, right)
  * @param left
  * @param right
+ * @param rand
  * @return
  */
-std::vector<vec2> generate_stars(const std::vector<vec2>& points, GLfloat gap = 0)
-{
-    return generate_stars(points.cbegin(), points.cend(), gap);
-}
-
-/**
- * Generate lines where first line has x coordinate as initial_p
- * @param initial_p
- * @return
- */
-std::vector<vec2> generate_lines(vec2 initial_p)
+static std::vector<vec2> generate_lines(GLfloat left, GLfloat right,
+                                        CounterRandom rand)
 {
-    //TODO: tune parameters
-    const GLfloat point_dist_min = frame_width / points_initial_size * 7.f;
-    const GLfloat point_dist_max = frame_width / points_initial_size * 9.f;
-
-    utils::Random rand;
-
     std::vector<vec2> points;
-    points.reserve(points_initial_size);
-    points.emplace_back(initial_p.x, rand.generaten(initial_p.y, deviation));
-    for (size_t i = 1; i < points_initial_size; ++i)
-        points.emplace_back(points[i - 1].x + rand.generateu(point_dist_min, point_dist_max),
-                            rand.generaten(points[i - 1].y, deviation)
-                            + rand.generateu(-deviation, deviation));
+    for (GLfloat x = left; x < right;
+         x += rand.generateu(point_dist_min, point_dist_max))
+        points.emplace_back(x, 0.f);
 
     return points;
 }
 
-std::vector<vec2> generate_platforms(std::vector<vec2> &points)
+/**
+ * Flatten some lines of points to platforms
+ * @param points
+ * @param rand
+ * @return pairs of points of platforms sorted by x
+ */
+static std::vector<vec2> generate_platforms(std::vector<vec2>& points,
+                                            CounterRandom rand)
 {
-    const int plat_count_min = points_initial_size / 8;
-    const int plat_count_max = points_initial_size / 3;
-
-    utils::Random rand;
-
-    size_t platforms_count = rand.generateu(plat_count_min, plat_count_max);
-    std::vector<GLuint> plat_idx(platforms_count, 0);
-    rand.fill_unique(plat_idx.begin(), plat_idx.end(), 0UL, points.size() - 2,
-                      true);
+    const size_t plat_count_min = points.size() / 8;
+    const size_t plat_count_max = points.size() / 3;
+
+    // Platforms don't touch each other. Any maximal set of such lines
+    // holds more than third of them, so loop ends.
+    const size_t platforms_count = rand.generateu(plat_count_min, plat_count_max);
+    std::vector<size_t> plat_idx;
+    plat_idx.reserve(platforms_count);
+    while (plat_idx.size() < platforms_count) {
+        const size_t idx = rand.generateu<size_t>(0, points.size() - 2);
+        if (std::none_of(plat_idx.cbegin(), plat_idx.cend(), [idx](size_t i) {
+            return i + 1 >= idx && i <= idx + 1;
+        }))
+            plat_idx.push_back(idx);
+    }
+    std::sort(plat_idx.begin(), plat_idx.end());
 
     std::vector<vec2> platforms;
-    platforms.reserve(platforms_count);
-    for (unsigned int i : plat_idx) {
+    platforms.reserve(platforms_count * 2);
+    for (size_t i : plat_idx) {
         points[i + 1].y = points[i].y;
         platforms.emplace_back(points[i]);
         platforms.emplace_back(points[i + 1]);
     }
-    platforms.shrink_to_fit();
 
     return platforms;
 }
 
-Level::Level() : max_right(0.f), max_left(0.f)
+Level::Level() : height_min(0.f), height_max(0.f), seed(0)
 {
-    point_dist_min = frame_width / points_initial_size * 7.f;
-    point_dist_max = frame_width / points_initial_size * 9.f;
 }
 
-void Level::extendToRight(const Camera& camera)
+GLfloat Level::border_height(std::ptrdiff_t index) const
 {
-    utils::Random rand;
-    GLfloat point_x = points.empty()
-                      ? 0.f
-                      : points.back().x
-                        + rand.generateu(point_dist_min, point_dist_max);
-    GLfloat point_y = points.empty()
-                      ? (height_min + height_max) / 2.f
-                      : points.back().y + rand.generateu(-deviation, deviation);
-    vec2 begin = vec2(point_x, point_y);
-    std::vector<vec2> part_lines = generate_lines(begin);
-    std::vector<vec2> part_platforms = generate_platforms(part_lines);
-    points.insert(points.end(), part_lines.cbegin(), part_lines.cend());
-    platforms.insert(platforms.end(), part_platforms.cbegin(), part_platforms.cend());
-
-    max_left = points[0].x + camera.getX();
-    max_right = points.back().x + camera.getX();
-
-    std::vector<vec2> part_stars = generate_stars(part_lines);
-    stars.insert(stars.end(), part_stars.cbegin(), part_stars.cend());
+    CounterRandom rand(seed, index, border_stream);
+    return rand.generateu(height_min, height_max);
 }
 
-void Level::extendToLeft(const Camera& camera)
+LevelChunkPtr Level::generate(std::ptrdiff_t index) const
 {
-    utils::Random rand;
-    GLfloat point_x = points.empty()
-                      ? -rand.generateu(point_dist_min, point_dist_max)
-                      : points[0].x - rand.generateu(point_dist_min, point_dist_max);
-    GLfloat point_y = points.empty()
-                      ? (height_min + height_max) / 2.f
-                      : (points[0].y + rand.generateu(-deviation, deviation));
-    vec2 begin = vec2(point_x, point_y);
-    std::vector<vec2> part_lines = generate_lines(begin);
-    part_lines = rotate_points(part_lines, 0);
-    std::vector<vec2> part_platforms = generate_platforms(part_lines);
-    points.insert(points.begin(), part_lines.cbegin(), part_lines.cend());
-    platforms.insert(platforms.begin(), part_platforms.cbegin(), part_platforms.cend());
-
-    // Update level borders
-    max_left = points[0].x + camera.getX();
-    max_right = points.back().x + camera.getX();
-
-    std::vector<vec2> part_stars = generate_stars(part_lines);
-    stars.insert(stars.begin(), part_stars.cbegin(), part_stars.cend());
-}
+    auto chunk = std::make_shared<LevelChunk>();
+    chunk->index = index;
+
+    const GLfloat left = index * Terrain::chunk_width;
+    chunk->points = generate_lines(left, left + Terrain::chunk_width,
+                                   CounterRandom(seed, index, lines_stream));
+    auto& points = chunk->points;
+
+    // Surface is random walk bent to meet heights of both borders
+    CounterRandom rand(seed, index, surface_stream);
+    GLfloat walk = 0.f;
+    for (auto& point: points) {
+        point.y = walk;
+        walk = rand.generaten(walk, deviation)
+               + rand.generateu(-deviation, deviation);
+    }
 
-void Level::extendToUp(std::vector<vec2>::iterator left,
-                       std::vector<vec2>::iterator right)
-{
-    // TODO: add stars extends to up
+    const GLfloat begin = border_height(index);
+    const GLfloat end = border_height(index + 1);
+    for (auto& point: points) {
+        const GLfloat t = (point.x - left) / Terrain::chunk_width;
+        point.y = begin + point.y + t * (end - begin - walk);
+    }
+    chunk->next = vec2(left + Terrain::chunk_width, end);
+
+    chunk->platforms = generate_platforms(
+            points, CounterRandom(seed, index, platforms_stream));
+    chunk->stars = generate_stars(points, CounterRandom(seed, index, stars_stream));
+    chunk->buildIndex();
+
+    return chunk;
 }
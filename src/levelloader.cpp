@@ -0,0 +1,122 @@
+#include <cassert>
+#include <chrono>
+
+#include "levelloader.hpp"
+
+// Chunks which follow needed ones in direction of motion are prefetched
+const std::ptrdiff_t prefetch_chunks = 2;
+// Loaded chunks farther than margin from needed ones are evicted, so
+// level isn't reloaded when ship goes back and forth near border
+const std::ptrdiff_t evict_margin = 2;
+// Request can be missed by sleeping worker, it waits not longer than this
+const std::chrono::milliseconds worker_sleep{5};
+
+LevelLoader::LevelLoader(bool async) : m_async(async)
+{
+}
+
+LevelLoader::~LevelLoader()
+{
+    m_stop.store(true, std::memory_order_release);
+    {
+        std::lock_guard lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void LevelLoader::start(const Level& level)
+{
+    assert(!m_worker.joinable() && "Level is generated already");
+    m_level = level;
+    if (m_async)
+        m_worker = std::thread([this] { work(); });
+}
+
+void LevelLoader::work()
+{
+    while (!m_stop.load(std::memory_order_acquire)) {
+        std::ptrdiff_t index;
+        if (!m_requests.pop(index)) {
+            std::unique_lock lock(m_sleepMutex);
+            m_wake.wait_for(lock, worker_sleep, [this] {
+                return m_stop.load(std::memory_order_acquire)
+                       || !m_requests.empty();
+            });
+            continue;
+        }
+
+        // Main thread requests no more chunks than queue holds
+        LevelChunkPtr chunk = m_level.generate(index);
+        while (!m_chunks.push(std::move(chunk))
+               && !m_stop.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+}
+
+LevelChunkPtr LevelLoader::take(std::ptrdiff_t index)
+{
+    auto it = m_ready.find(index);
+    if (it == m_ready.end())
+        return m_level.generate(index);
+
+    LevelChunkPtr chunk = std::move(it->second);
+    m_ready.erase(it);
+    return chunk;
+}
+
+void LevelLoader::request(const Terrain& terrain, std::ptrdiff_t index)
+{
+    if (terrain.contains(index) || m_ready.count(index)
+        || m_pending.count(index) || m_pending.size() >= queue_size)
+        return;
+
+    std::ptrdiff_t value = index;
+    if (m_requests.push(std::move(value))) {
+        m_pending.insert(index);
+        m_wake.notify_one();
+    }
+}
+
+void LevelLoader::load(Terrain& terrain, std::ptrdiff_t first,
+                       std::ptrdiff_t last, int direction)
+{
+    LevelChunkPtr received;
+    while (m_chunks.pop(received)) {
+        m_pending.erase(received->index);
+        const auto index = received->index;
+        m_ready.emplace(index, std::move(received));
+    }
+
+    if (terrain.empty())
+        terrain.pushBack(take(first));
+    while (terrain.firstIndex() > first)
+        terrain.pushFront(take(terrain.firstIndex() - 1));
+    while (terrain.endIndex() <= last)
+        terrain.pushBack(take(terrain.endIndex()));
+
+    while (terrain.firstIndex() < first - evict_margin)
+        terrain.popFront();
+    while (terrain.endIndex() - 1 > last + evict_margin)
+        terrain.popBack();
+
+    // Received chunks which won't be needed soon are dropped
+    const std::ptrdiff_t keep = evict_margin + prefetch_chunks;
+    for (auto it = m_ready.begin(); it != m_ready.end();) {
+        if (it->first < first - keep || it->first > last + keep)
+            it = m_ready.erase(it);
+        else
+            ++it;
+    }
+
+    if (!m_async)
+        return;
+
+    for (std::ptrdiff_t i = 1; i <= prefetch_chunks; ++i) {
+        if (direction >= 0)
+            request(terrain, last + i);
+        if (direction <= 0)
+            request(terrain, first - i);
+    }
+}
@@ -1,8 +1,17 @@
 #include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <random>
 #include <glm/gtc/matrix_transform.hpp>
+#include <boost/format.hpp>
 
 #include "game.hpp"
+#include "simulation.hpp"
 #include "moonlanderprogram.hpp"
+#include "particleprogram.hpp"
 #include "utils/logger.hpp"
 #include "exceptions/basegameexception.hpp"
 
@@ -12,12 +21,91 @@
 
 using utils::log::program_log_file_name;
 using utils::log::Category;
+using boost::format;
+
+/**
+ * Run landings without window and print outcome of each lander
+ * and summary, one line per lander
+ * @param simulation
+ * @param runs
+ */
+void run_headless(Simulation& simulation, size_t runs)
+{
+    const char* const outcomes[] = {"timeout", "landed", "crashed"};
+    size_t landers = 0;
+    size_t landed = 0;
+    size_t steps = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < runs; ++i) {
+        const std::vector<SimulationResult> results = simulation.run();
+        for (size_t j = 0; j < results.size(); ++j) {
+            const SimulationResult& res = results[j];
+            landed += res.state == GameStates::WIN;
+            steps += res.steps;
+            std::cout << format("run %1% lander %2% %3% steps %4% fuel %5%\n")
+                         % i % j % outcomes[static_cast<size_t>(res.state)]
+                         % res.steps % res.fuel;
+        }
+        landers += results.size();
+    }
+    const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+    std::cout << format("landed %1% of %2%, %3% steps, %4% runs/s, %5% landers/s\n")
+                 % landed % landers % steps % (runs / elapsed.count())
+                 % (landers / elapsed.count());
+}
 
 int main(int argc, char *args[])
 {
     int ret_code = 0;
     try {
+        size_t tick_rate = sim_tick_rate;
+        bool headless = false;
+        size_t runs = 1;
+        size_t landers = 1;
+        size_t max_steps = headless_max_steps;
+        std::string script;
+        std::optional<std::uint64_t> seed;
+
+        const std::string tick_rate_option = "--tick-rate=";
+        const std::string runs_option = "--runs=";
+        const std::string landers_option = "--landers=";
+        const std::string max_steps_option = "--max-steps=";
+        const std::string script_option = "--script=";
+        const std::string seed_option = "--seed=";
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = args[i];
+            if (arg.rfind(tick_rate_option, 0) == 0)
+                tick_rate = std::stoul(arg.substr(tick_rate_option.size()));
+            else if (arg == "--headless")
+                headless = true;
+            else if (arg.rfind(runs_option, 0) == 0)
+                runs = std::stoul(arg.substr(runs_option.size()));
+            else if (arg.rfind(landers_option, 0) == 0)
+                landers = std::stoul(arg.substr(landers_option.size()));
+            else if (arg.rfind(max_steps_option, 0) == 0)
+                max_steps = std::stoul(arg.substr(max_steps_option.size()));
+            else if (arg.rfind(script_option, 0) == 0)
+                script = arg.substr(script_option.size());
+            else if (arg.rfind(seed_option, 0) == 0)
+                seed = std::stoull(arg.substr(seed_option.size()));
+        }
+
+        if (headless) {
+            Simulation simulation(script.empty() ? utils::InputScript()
+                                                 : utils::InputScript(script),
+                                  tick_rate, max_steps,
+                                  seed.value_or(std::random_device()()), landers);
+            run_headless(simulation, runs);
+            return ret_code;
+        }
+
         Game game;
+        game.setTickRate(tick_rate);
+        if (seed)
+            game.setSeed(*seed);
+
         game.initOnceSDL2();
         game.initGL();
         game.initGame();
@@ -38,12 +126,16 @@ int main(int argc, char *args[])
         program->setTexture(0);
 
         program->switchToLinesAdj();
+        ParticleProgram::getInstance()->loadProgram();
 
         SDL_Event e;
         int32_t tick_interval = 1000 / 60;
         size_t last_update_time = 0;
         int32_t delta_time = 0;
         size_t cur_time = 0;
+        // Real time between frames for fixed step clock, microseconds
+        const Uint64 counter_frequency = SDL_GetPerformanceFrequency();
+        Uint64 last_counter = SDL_GetPerformanceCounter();
 
 #ifndef NDEBUG
             CALLGRIND_START_INSTRUMENTATION;
@@ -67,7 +159,9 @@ int main(int argc, char *args[])
                 if (e.type == SDL_QUIT)
                     setGameRunnable(false);
 
-            game.update(delta_time);
+            const Uint64 counter = SDL_GetPerformanceCounter();
+            game.update((counter - last_counter) * 1000000 / counter_frequency);
+            last_counter = counter;
             game.flush();
 
             if (!game.vsync_supported)
@@ -0,0 +1,201 @@
+#include <GL/glew.h>
+#include <boost/format.hpp>
+
+#include "utils/utils.hpp"
+#include "utils/logger.hpp"
+#include "exceptions/glexception.hpp"
+#include "particleprogram.hpp"
+
+using utils::getShaderPath;
+using utils::loadShaderFromFile;
+using utils::log::Category;
+using utils::log::program_log_file_name;
+using boost::format;
+
+// Floats per particle in instance buffer
+const size_t instance_size = 4;
+
+std::shared_ptr<ParticleProgram> ParticleProgram::instance = nullptr;
+
+void ParticleProgram::loadProgram()
+{
+    m_programID = glCreateProgram();
+    if (m_programID == 0)
+        throw GLException("Unable to create particle program\n",
+                          program_log_file_name(),
+                          Category::INITIALIZATION_ERROR);
+
+    GLuint vertexShader = loadShaderFromFile(
+            getShaderPath("particle.glvs"), GL_VERTEX_SHADER);
+    GLuint fragmentShader = loadShaderFromFile(
+            getShaderPath("particle.glfs"), GL_FRAGMENT_SHADER);
+
+    glAttachShader(m_programID, vertexShader);
+    glAttachShader(m_programID, fragmentShader);
+    glLinkProgram(m_programID);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint linkSuccess = GL_TRUE;
+    glGetProgramiv(m_programID, GL_LINK_STATUS, &linkSuccess);
+    if (linkSuccess != GL_TRUE) {
+        utils::log::printProgramLog(m_programID);
+        throw GLException((format("Unable to link program: %d\n")
+                           % m_programID).str(),
+                          program_log_file_name(),
+                          Category::INITIALIZATION_ERROR);
+    }
+
+    // Matrices are written by MoonLanderProgram to binding point 1
+    glUniformBlockBinding(m_programID,
+                          glGetUniformBlockIndex(m_programID, "Matrices"), 1);
+
+    m_texLoc = uniform_location("ourTexture");
+    m_clipsLoc = uniform_location("Clips");
+    m_textureSizeLoc = uniform_location("TextureSize");
+    m_scaleLoc = uniform_location("Scale");
+
+    const GLfloat corners[] = {
+            0.f, 0.f,
+            1.f, 0.f,
+            1.f, 1.f,
+            0.f, 1.f
+    };
+    const GLuint indices[] = {
+            0, 1, 2,
+            0, 2, 3
+    };
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_quadVBO);
+    glGenBuffers(1, &m_EBO);
+    glGenBuffers(1, &m_instanceVBO);
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices,
+                 GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat),
+                          nullptr);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glVertexAttribPointer(1, instance_size, GL_FLOAT, GL_FALSE,
+                          instance_size * sizeof(GLfloat), nullptr);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    if (GLenum error = glGetError(); error != GL_NO_ERROR)
+        throw GLException((format("Unable to create particle buffers! %s\n")
+                           % gluErrorString(error)).str(),
+                          program_log_file_name(),
+                          Category::INITIALIZATION_ERROR);
+}
+
+void ParticleProgram::draw(const Sprite& sprite, const ParticlePool& pool,
+                           GLfloat back, GLfloat scale)
+{
+    const size_t count = pool.size();
+    if (count == 0)
+        return;
+
+    const auto& spriteClips = sprite.getClips();
+    assert(spriteClips.size() <= max_clips && "Too many particle clips");
+    reserve_instances(pool.capacity());
+
+    const auto& coords = pool.getCoords();
+    const auto& vel = pool.getVel();
+    const auto& clips = pool.getClips();
+    GLfloat* data = m_instances.data();
+    for (size_t i = 0; i < count; ++i, data += instance_size) {
+        data[0] = coords.x[i] - vel.x[i] * back;
+        data[1] = coords.y[i] - vel.y[i] * back;
+        data[2] = coords.angle[i] - vel.angle[i] * back;
+        data[3] = static_cast<GLfloat>(clips[i]);
+    }
+
+    glUniform4fv(m_clipsLoc, spriteClips.size(), &spriteClips[0].x);
+    glUniform2f(m_textureSizeLoc, sprite.getTextureWidth(),
+                sprite.getTextureHeight());
+    glUniform1f(m_scaleLoc, scale);
+    glUniform1i(m_texLoc, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    const GLsizeiptr bytes = m_instanceCapacity * instance_size * sizeof(GLfloat);
+    // Orphan storage of previous draw so driver doesn't wait for it
+    glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * instance_size * sizeof(GLfloat),
+                    m_instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindTexture(GL_TEXTURE_2D, sprite.getTextureID());
+    glBindVertexArray(m_vao);
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, count);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (GLenum error = glGetError(); error != GL_NO_ERROR) {
+        utils::log::printProgramLog(m_programID);
+        throw GLException((format("Error while drawing particles! %s\n")
+                           % gluErrorString(error)).str(),
+                          program_log_file_name(),
+                          Category::INTERNAL_ERROR);
+    }
+}
+
+void ParticleProgram::updateProjection()
+{
+}
+
+void ParticleProgram::updateView()
+{
+}
+
+void ParticleProgram::updateModel()
+{
+}
+
+ParticleProgram::~ParticleProgram()
+{
+    free_buffers();
+}
+
+GLint ParticleProgram::uniform_location(const std::string& name)
+{
+    GLint loc = glGetUniformLocation(m_programID, name.c_str());
+    if (loc == -1) {
+        utils::log::printProgramLog(m_programID);
+        throw GLException((format("%s is not a valid glsl program variable!\n")
+                           % name).str(),
+                          program_log_file_name(),
+                          Category::INITIALIZATION_ERROR);
+    }
+
+    return loc;
+}
+
+void ParticleProgram::reserve_instances(size_t count)
+{
+    if (count <= m_instanceCapacity)
+        return;
+
+    m_instanceCapacity = count;
+    m_instances.resize(count * instance_size);
+}
+
+void ParticleProgram::free_buffers()
+{
+    glDeleteBuffers(1, &m_instanceVBO);
+    glDeleteBuffers(1, &m_EBO);
+    glDeleteBuffers(1, &m_quadVBO);
+    glDeleteVertexArrays(1, &m_vao);
+
+    m_instanceVBO = m_EBO = m_quadVBO = m_vao = 0;
+}
@@ -1,9 +1,9 @@
+#include <glm/gtc/matrix_transform.hpp>
+
 #include "render/camera.hpp"
 
 void Camera::lookAt(GLfloat x, GLfloat y)
 {
-    m_prevX = m_x;
-    m_prevY = m_y;
     m_x = x;
     m_y = y;
 }
@@ -20,13 +20,11 @@ GLfloat Camera::getY() const
 
 void Camera::setX(GLfloat x)
 {
-    m_prevX = m_x;
     m_x = x;
 }
 
 void Camera::setY(GLfloat y)
 {
-    m_prevY = m_y;
     m_y = y;
 }
 
@@ -38,19 +36,21 @@ Camera::Camera() : m_x(0.f), m_y(0.f)
 
 void Camera::translate(GLfloat x, GLfloat y)
 {
-    m_prevX = m_x;
-    m_prevY = m_y;
-
     m_x += x;
     m_y += y;
 }
 
-GLfloat Camera::deltaY() const
+void Camera::save()
 {
-    return m_y - m_prevY;
+    m_prevX = m_x;
+    m_prevY = m_y;
 }
 
-GLfloat Camera::deltaX() const
+glm::mat4 Camera::getView(GLfloat alpha, GLfloat scale) const
 {
-    return m_x - m_prevX;
-}
\ No newline at end of file
+    const GLfloat x = glm::mix(m_prevX, m_x, alpha);
+    const GLfloat y = glm::mix(m_prevY, m_y, alpha);
+    // Model matrix scales world, so camera position is scaled as well
+    return glm::translate(glm::mat4(1.f),
+                          glm::vec3(-x * scale, -y * scale, 0.f));
+}
@@ -56,6 +56,11 @@ utils::Rect Sprite::getClip(GLuint idx) noexcept
     return m_clips[idx];
 }
 
+const std::vector<utils::Rect>& Sprite::getClips() const noexcept
+{
+    return m_clips;
+}
+
 void Sprite::generateDataBuffer()
 {
     if (m_textureId != 0 && !m_clips.empty()) {
@@ -11,6 +11,11 @@ using boost::format;
 
 void TextTexture::setText(const std::string& text)
 {
+    // Rasterizing and uploading of text is expensive, while most of
+    // HUD doesn't change between frames
+    if (text == m_text)
+        return;
+
     load(text, m_color, m_font);
     m_text = text;
 }
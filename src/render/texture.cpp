@@ -16,6 +16,16 @@ GLuint Texture::getHeight() const noexcept
     return m_textureHeight;
 }
 
+GLuint Texture::getTextureWidth() const noexcept
+{
+    return m_textureWidth;
+}
+
+GLuint Texture::getTextureHeight() const noexcept
+{
+    return m_textureHeight;
+}
+
 GLuint Texture::getTextureID() const
 {
     return m_textureId;
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cassert>
+
+#include "render/vertexbuffer.hpp"
+
+// Minimal capacity of buffer storage, in vertices
+const size_t min_capacity = 1024;
+
+render::VertexBuffer::~VertexBuffer()
+{
+    glDeleteBuffers(1, &m_vbo);
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void render::VertexBuffer::pushFront(const vec2* vertices, size_t count)
+{
+    reserve(count, 0);
+    m_begin -= count;
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, m_begin * sizeof(vec2),
+                    count * sizeof(vec2), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void render::VertexBuffer::pushBack(const vec2* vertices, size_t count)
+{
+    reserve(0, count);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, m_end * sizeof(vec2),
+                    count * sizeof(vec2), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_end += count;
+}
+
+void render::VertexBuffer::popFront(size_t count) noexcept
+{
+    assert(count <= size());
+    m_begin += count;
+}
+
+void render::VertexBuffer::popBack(size_t count) noexcept
+{
+    assert(count <= size());
+    m_end -= count;
+}
+
+void render::VertexBuffer::clear() noexcept
+{
+    m_begin = m_end = m_capacity / 2;
+}
+
+size_t render::VertexBuffer::size() const noexcept
+{
+    return m_end - m_begin;
+}
+
+void render::VertexBuffer::draw(GLenum mode) const
+{
+    if (size() == 0)
+        return;
+
+    glBindVertexArray(m_vao);
+    glDrawArrays(mode, m_begin, size());
+    glBindVertexArray(0);
+}
+
+void render::VertexBuffer::reserve(size_t front, size_t back)
+{
+    if (m_begin >= front && m_capacity - m_end >= back)
+        return;
+
+    const size_t count = size();
+    const size_t needed = count + front + back;
+    // Storage which is less than half full is only recentered
+    const size_t capacity = 2 * needed <= m_capacity
+                            ? m_capacity
+                            : std::max({2 * m_capacity, 2 * needed, min_capacity});
+    // Spare room is split evenly between both ends
+    const size_t begin = front + (capacity - needed) / 2;
+
+    if (m_vao == 0)
+        glGenVertexArrays(1, &m_vao);
+
+    GLuint vbo = 0;
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * sizeof(vec2), nullptr,
+                 GL_STATIC_DRAW);
+    if (count > 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, m_vbo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                            m_begin * sizeof(vec2), begin * sizeof(vec2),
+                            count * sizeof(vec2));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &m_vbo);
+
+    m_vbo = vbo;
+    m_begin = begin;
+    m_end = begin + count;
+    m_capacity = capacity;
+
+    // Vertex array keeps buffer which was bound when attribute was set
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
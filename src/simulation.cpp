@@ -0,0 +1,49 @@
+#include <stdexcept>
+#include <thread>
+
+#include "simulation.hpp"
+#include "world.hpp"
+
+Simulation::Simulation(utils::InputScript script, size_t tickRate,
+                       size_t maxSteps, std::uint64_t seed, size_t landers)
+        : m_script(std::move(script)), m_maxSteps(maxSteps), m_seed(seed),
+          m_landers(landers)
+{
+    if (tickRate == 0)
+        throw std::invalid_argument("Tick rate must be positive");
+    if (landers == 0)
+        throw std::invalid_argument("Number of landers must be positive");
+
+    m_step = 1000000 / tickRate;
+}
+
+std::vector<SimulationResult> Simulation::run()
+{
+    // Single lander isn't worth threads
+    World world(true, m_landers > 1 ? std::thread::hardware_concurrency() : 1);
+    world.setInputScript(&m_script);
+    world.setSeed(m_seed + m_runs++);
+    world.setLanders(m_landers);
+
+    setGameState(GameStates::NORMAL);
+    world.init();
+    while (world.isFlying() && world.getSteps() < m_maxSteps)
+        world.update(m_step);
+
+    std::vector<SimulationResult> results;
+    results.reserve(world.getLanders());
+    for (size_t i = 0; i < world.getLanders(); ++i) {
+        const LanderComponent lander = world.getLander(i);
+        if (lander.state == LanderState::FLYING) {
+            results.push_back({GameStates::NORMAL, world.getSteps(), world.getFuel(i)});
+            continue;
+        }
+
+        // Lander finished on the step it touched level
+        results.push_back({lander.state == LanderState::LANDED ? GameStates::WIN
+                                                               : GameStates::FAIL,
+                           lander.steps + 1, world.getFuel(i)});
+    }
+
+    return results;
+}
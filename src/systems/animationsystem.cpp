@@ -2,9 +2,9 @@
 
 void AnimationSystem::update_state(size_t delta)
 {
-    auto entities = getEntities();
-    for (auto& [key, en]: entities) {
-        en->getComponent<SpriteComponent>()->sprite->setIdx(
-                en->getComponent<AnimationComponent>()->cur_state);
-    }
+    // Clip of sprite is switched only when state of animation changed
+    forEach<ecs::Write<SpriteComponent>, ecs::Changed<AnimationComponent>>(
+            [](SpriteComponent& sprite, const AnimationComponent& anim) {
+                sprite.sprite->setIdx(anim.cur_state);
+            });
 }
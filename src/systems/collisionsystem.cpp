@@ -1,85 +1,87 @@
-#include <numeric>
-#include <iostream>
+#include <algorithm>
+#include <cmath>
 
 #include "systems/collisionsystem.hpp"
-#include "utils/collision.hpp"
+#include "collision/kernels.hpp"
 
 using glm::vec2;
 
 void CollisionSystem::update_state(size_t delta)
 {
     auto levels = getEntitiesByTag<LevelComponent>();
-    auto sprites = getEntitiesByTags<SpriteComponent, CollisionComponent>();
-
-    const int critAlt = 250;
 
     // We need to check we have only one level (otherwise will be strange)
     assert(levels.size() == 1);
 
-    auto level = levels.begin()->second->getComponent<LevelComponent>();
-    auto levelCol = levels.begin()->second->getComponent<CollisionComponent>();
-    for (auto &[key, spriteEntity] : sprites) {
-        auto colComponent = spriteEntity->getComponent<CollisionComponent>();
-        auto sprite = spriteEntity->getComponent<SpriteComponent>()->sprite;
-        auto pos = spriteEntity->getComponent<PositionComponent>();
-        if (utils::physics::altitude(level->points, pos->x, pos->y) >= critAlt)
-            return;
+    const auto& terrain = levels.front().getComponent<LevelComponent>()->terrain;
+    auto levelCol = levels.front().getComponent<CollisionComponent>();
 
-        if (levelSpriteCollision(*sprite, pos->x, pos->y,
-                                 level->points, level->stars, pos->angle)) {
-            colComponent->has_collision = true;
-            levelCol->has_collision = true;
-        } else {
-            colComponent->has_collision = false;
-            levelCol->has_collision = false;
-        }
-    }
-}
+    // Broad phase: pair each box with segments whose bounding boxes
+    // overlap bounding box of its path during step. Box keeps its
+    // current angle along the path, rotation per step is small.
+    m_pairs.clear();
+    m_segments.clear();
+    m_bodies.clear();
+    forEach<CollisionComponent, PositionComponent>(
+            [this, &terrain](CollisionComponent& col, PositionComponent& pos) {
+        const coll::OrientedBox box = coll::buildOrientedBox(
+                {pos.prev_x, pos.prev_y, col.width, col.height}, pos.angle);
+        const vec2 motion(pos.x - pos.prev_x, pos.y - pos.prev_y);
+        const vec2 extent(box.half_w * std::fabs(box.axis.x)
+                          + box.half_h * std::fabs(box.axis.y),
+                          box.half_w * std::fabs(box.axis.y)
+                          + box.half_h * std::fabs(box.axis.x));
+        const vec2 end = box.center + motion;
+        const vec2 min(std::min(box.center.x, end.x), std::min(box.center.y, end.y));
+        const vec2 max(std::max(box.center.x, end.x), std::max(box.center.y, end.y));
 
-/**
- * Find lines that affected by any of points of rectangle rect
- * @param rect
- * @param points
- * @return
- */
-std::vector<size_t> find_lines_under(const utils::RectPoints& rect,
-                                     const std::vector<vec2> &points)
-{
-    GLfloat left_most = std::min({rect.a.x, rect.b.x, rect.c.x, rect.d.x});
-    size_t line_idx = std::prev(
-            std::lower_bound(points.cbegin(), points.cend(), left_most,
-                             [](const vec2& point, GLfloat val) {
-                                 return point.x < val;
-                             })) - points.cbegin();
-
-    // Assume that ship can't be place at more than 4 lines simultaneously
-    std::vector<size_t> res(4);
-    std::iota(res.begin(), res.end(), line_idx);
-
-    return res;
-}
+        const size_t first = m_pairs.size();
+        terrain.forEachSegment(min - extent, max + extent,
+                               [this, &box, &motion](const vec2& p, const vec2& q,
+                                                     TerrainSegment segment) {
+            m_pairs.push_back(box, motion, p, q);
+            m_segments.push_back(segment);
+        });
+        m_bodies.push_back({&col, &pos, first, m_pairs.size()});
+    });
 
+    // Narrow phase
+    m_contacts.resize(m_pairs.size());
+    parallelFor(m_pairs.size(), collision_grain, [this](size_t begin, size_t end) {
+        coll::boxSegment(m_pairs, m_contacts, begin, end);
+    });
 
-bool
-CollisionSystem::levelSpriteCollision(const Sprite &sprite, GLfloat ship_x,
-                                      GLfloat ship_y, const std::vector<vec2> &points,
-                                      const std::vector<vec2> &stars, GLfloat angle)
-{
-    utils::Rect coords = sprite.getCurrentClip();
-    coords.x = ship_x;
-    coords.y = ship_y;
-    utils::RectPoints r = coll::buildRectPoints(coords, angle);
+    // Each body takes its earliest contact, the deepest one of
+    // simultaneous, and is moved back to it
+    parallelFor(m_bodies.size(), body_grain, [this, &terrain](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            auto [col, pos, first, last] = m_bodies[b];
+            col->has_collision = false;
+            col->toi = 1.f;
+            col->penetration = 0.f;
+            for (size_t i = first; i < last; ++i) {
+                const GLfloat toi = m_contacts.toi[i];
+                if (toi > col->toi || (col->has_collision && toi == col->toi
+                                       && m_contacts.depth[i] <= col->penetration))
+                    continue;
 
-    std::vector<size_t> lines = find_lines_under(r, points);
+                col->has_collision = true;
+                col->toi = toi;
+                col->contact = m_segments[i];
+                col->penetration = m_contacts.depth[i];
+                col->normal = vec2(m_contacts.nx[i], m_contacts.ny[i]);
+            }
 
-    return std::any_of(lines.cbegin(), lines.cend(), [points, r](size_t idx) {
-        vec2 p = points[idx];
-        vec2 p_right = points[idx + 1];
-        bool left = coll::lineLine(r.d, r.a, {p.x, p.y}, {p_right.x, p_right.y});
-        bool right = coll::lineLine(r.b, r.c, {p.x, p.y}, {p_right.x, p_right.y});
-        bool top = coll::lineLine(r.c, r.d, {p.x, p.y}, {p_right.x, p_right.y});
-        bool bottom = coll::lineLine(r.a, r.b, {p.x, p.y}, {p_right.x, p_right.y});
+            if (col->has_collision && col->toi < 1.f) {
+                pos->x = pos->prev_x + (pos->x - pos->prev_x) * col->toi;
+                pos->y = pos->prev_y + (pos->y - pos->prev_y) * col->toi;
+            }
+            col->altitude = terrain.altitude(pos->x, pos->y, col->hint);
+        }
+    });
 
-        return left || right || top || bottom;
+    levelCol->has_collision = std::any_of(m_bodies.cbegin(), m_bodies.cend(),
+                                          [](const Body& body) {
+        return body.col->has_collision;
     });
-}
\ No newline at end of file
+}
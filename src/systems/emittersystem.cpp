@@ -0,0 +1,59 @@
+#include <glm/gtc/constants.hpp>
+
+#include "systems/emittersystem.hpp"
+#include "components/particlespritecomponent.hpp"
+#include "ecs/ecsmanager.hpp"
+#include "utils/utils.hpp"
+
+EmitterSystem::EmitterSystem()
+{
+    writes<ParticleSpriteComponent>();
+}
+
+void EmitterSystem::update_state(size_t delta)
+{
+    utils::ScopedProfile profile(m_counter);
+    const GLfloat k = utils::physics::step_scale(delta);
+    forEach<EmitterComponent, ecs::Read<PositionComponent>, ecs::Read<VelocityComponent>>(
+            [this, delta, k](EmitterComponent& emitter, const PositionComponent& pos,
+                             const VelocityComponent& vel) {
+                if (!emitter.active) {
+                    emitter.accumulator = 0.f;
+                    return;
+                }
+
+                emitter.accumulator += emitter.rate * delta / 1000000.f;
+                const auto count = static_cast<size_t>(emitter.accumulator);
+                emitter.accumulator -= count;
+                if (count == 0)
+                    return;
+
+                auto particle = m_ecsManager->getEntity(emitter.pool)
+                        .getComponent<ParticleSpriteComponent>();
+                auto& particles = particle->particles;
+                const GLuint clips = particle->sprite->getSpritesCount();
+
+                // Exhaust is opposite to direction of entity
+                const GLfloat dir = pos.angle + glm::half_pi<GLfloat>();
+                const GLfloat nozzleX = pos.x + emitter.origin_x
+                                        + std::cos(dir) * emitter.nozzle;
+                const GLfloat nozzleY = pos.y + emitter.origin_y
+                                        + std::sin(dir) * emitter.nozzle;
+                for (size_t i = 0; i < count; ++i) {
+                    const GLfloat angle = m_rand.generaten(dir, emitter.spread);
+                    const utils::Position pvel{
+                            vel.x + std::cos(angle) * emitter.speed,
+                            vel.y + std::sin(angle) * emitter.speed,
+                            0.f};
+                    // Spread particles along the step instead of one clump
+                    const GLfloat t = m_rand.generateu(0.f, k);
+                    particles.spawn({nozzleX + pvel.x * t, nozzleY + pvel.y * t, angle},
+                                    pvel, i % clips);
+                }
+            });
+}
+
+utils::ProfileCounter& EmitterSystem::getCounter() noexcept
+{
+    return m_counter;
+}
@@ -1,14 +1,25 @@
 #include "systems/keyboardsystem.hpp"
 #include "game.hpp"
+#include "components/velocitycomponent.hpp"
+#include "components/positioncomponent.hpp"
+#include "components/animationcomponent.hpp"
+#include "components/lifetimecomponent.hpp"
+#include "components/emittercomponent.hpp"
+
+KeyboardSystem::KeyboardSystem()
+{
+    writes<VelocityComponent, AnimationComponent, LifeTimeComponent,
+            EmitterComponent>();
+    reads<PositionComponent>();
+    setMainThread();
+}
 
 void KeyboardSystem::update_state(size_t delta)
 {
-    auto handles = getEntities();
-    for (auto& [key, en] : handles)
-        en->getComponent<KeyboardComponent>()->event_handler(
-                SDL_GetKeyboardState(nullptr));
+    const Uint8* state = m_state ? m_state : SDL_GetKeyboardState(nullptr);
 
-    const Uint8* state = SDL_GetKeyboardState(nullptr);
+    for (auto en: getEntities())
+        en.getComponent<KeyboardComponent>()->event_handler(state, delta);
 
     if (state[SDL_SCANCODE_RETURN]
         && (getGameState() == GameStates::FAIL
@@ -17,4 +28,9 @@ void KeyboardSystem::update_state(size_t delta)
 
     if (state[SDL_SCANCODE_ESCAPE])
         setGameRunnable(false);
+}
+
+void KeyboardSystem::setKeyboardState(const Uint8* state) noexcept
+{
+    m_state = state;
 }
\ No newline at end of file
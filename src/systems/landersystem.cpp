@@ -0,0 +1,87 @@
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+#include "systems/landersystem.hpp"
+#include "utils/utils.hpp"
+
+void LanderSystem::update_state(size_t delta)
+{
+    auto levels = getEntitiesByTag<LevelComponent>();
+    assert(levels.size() == 1);
+
+    const auto& terrain = levels.front().getComponent<LevelComponent>()->terrain;
+    const GLfloat k = utils::physics::step_scale(delta);
+    const size_t step = m_step;
+    parallelForEach<LanderComponent, VelocityComponent, LifeTimeComponent,
+            ecs::Read<PositionComponent>, ecs::Read<CollisionComponent>>(
+            [&terrain, k, step](LanderComponent& lander, VelocityComponent& vel,
+                                LifeTimeComponent& fuel, const PositionComponent& pos,
+                                const CollisionComponent& col) {
+        if (lander.state == LanderState::FLYING && col.has_collision) {
+            lander.state = landed(terrain, pos, vel, col) ? LanderState::LANDED
+                                                          : LanderState::CRASHED;
+            lander.steps = step;
+        }
+
+        // Crashed lander keeps velocity of impact for one step, so debris
+        // of ship fly on, then landers stay where they touched level
+        if (lander.state != LanderState::FLYING) {
+            if (lander.state == LanderState::LANDED || lander.steps != step)
+                vel.x = vel.y = vel.angle = 0.f;
+            return;
+        }
+
+        if (lander.script)
+            steer(lander.script->controls(step), pos, vel, fuel, k);
+    });
+}
+
+void LanderSystem::setStep(size_t step) noexcept
+{
+    m_step = step;
+}
+
+bool LanderSystem::steer(const utils::InputScript::Controls& controls,
+                         const PositionComponent& pos, VelocityComponent& vel,
+                         LifeTimeComponent& fuel, GLfloat k) noexcept
+{
+    const bool thrust = controls.up && fuel.time > 0;
+    if (thrust) {
+        vel.y += -engine_force / weight * k
+                 * std::sin(pos.angle + glm::half_pi<GLfloat>());
+        vel.x += -engine_force / weight * k
+                 * std::cos(pos.angle + glm::half_pi<GLfloat>());
+        fuel.time -= k;
+    }
+
+    if (controls.left)
+        vel.angle -= rot_step * k;
+
+    if (controls.right)
+        vel.angle += rot_step * k;
+
+    return thrust;
+}
+
+bool LanderSystem::landed(const Terrain& terrain, const PositionComponent& pos,
+                          const VelocityComponent& vel,
+                          const CollisionComponent& col) noexcept
+{
+    const GLfloat angle = pos.angle - glm::two_pi<GLfloat>()
+                                      * std::floor(pos.angle / glm::two_pi<GLfloat>());
+    const GLfloat crit_angle = glm::pi<GLfloat>() / 6.f;
+    if (!((angle >= -crit_angle && angle <= crit_angle)
+          || (angle >= glm::two_pi<GLfloat>() - crit_angle))
+        || std::abs(vel.y * 60.f) > 20)
+        return false;
+
+    const GLfloat pad = 2;
+    bool landed = false;
+    terrain.forEachPlatform(pos.x - pad, pos.x + col.width + pad,
+                            [&](const vec2& left, const vec2& right) {
+        landed = landed || (pos.x >= left.x - pad
+                            && pos.x + col.width <= right.x + pad);
+    });
+
+    return landed;
+}
@@ -1,32 +1,30 @@
 #include "systems/movementsystem.hpp"
+#include "utils/utils.hpp"
+#include "particle/kernels.hpp"
 
 void MovementSystem::update_state(size_t delta)
 {
-    auto entities = getEntitiesByTags<PositionComponent, VelocityComponent>();
-    for (auto& [key, en]: entities) {
-        auto pos = en->getComponent<PositionComponent>();
-        const auto vel = en->getComponent<VelocityComponent>();
+    const GLfloat k = utils::physics::step_scale(delta);
+    parallelForEach<PositionComponent, ecs::Read<VelocityComponent>>(
+            [k](PositionComponent& pos, const VelocityComponent& vel) {
+                pos.x += vel.x * k;
+                pos.y += vel.y * k;
+                pos.angle += vel.angle * k;
+            });
 
-        pos->x += vel->x;
-        pos->y += vel->y;
-        pos->angle += vel->angle;
-    }
-
-    auto particles = getEntitiesByTag<ParticleSpriteComponent>();
-    for (auto& [key, en]: particles) {
-        auto particle =  en->getComponent<ParticleSpriteComponent>();
-
-        auto& coords = particle->coords;
-        const auto& vel = particle->vel;
+    // Particles are moved and fall in one pass over their arrays
+    const GLfloat gravity = gravity_force / weight * k;
+    forEach<ParticleSpriteComponent>([this, k, gravity](ParticleSpriteComponent& particle) {
+        auto& coords = particle.particles.getCoords();
+        auto& vel = particle.particles.getVel();
         assert(coords.size() == vel.size()
                && "Number of coordinates must be "
                   "the same as number of velocities");
-        for(size_t i = 0; i < coords.size(); ++i) {
-            coords[i].x += vel[i].x;
-            coords[i].y += vel[i].y;
-            coords[i].angle += vel[i].angle;
-        }
-    }
+        parallelFor(coords.size(), particle_grain, [&coords, &vel, k, gravity](size_t begin,
+                                                                               size_t end) {
+            particle::integrate(coords, vel, k, gravity, begin, end);
+        });
+    });
 }
 
 MovementSystem::MovementSystem()
@@ -1,21 +1,43 @@
 #include <cstdlib>
 
 #include "systems/particlerendersystem.hpp"
-#include "render/render.hpp"
+#include "particleprogram.hpp"
 #include "moonlanderprogram.hpp"
+#include "utils/utils.hpp"
+
+ParticleRenderSystem::ParticleRenderSystem()
+{
+    setMainThread();
+    setStage(render_stage);
+}
+
+void ParticleRenderSystem::setInterpolation(GLfloat alpha, size_t step)
+{
+    m_alpha = alpha;
+    m_step = step;
+}
+
+void ParticleRenderSystem::setView(const glm::mat4& view, GLfloat scale)
+{
+    m_view = view;
+    m_scale = scale;
+}
 
 void ParticleRenderSystem::update_state(size_t delta)
 {
-    auto program = MoonLanderProgram::getInstance();
+    auto program = ParticleProgram::getInstance();
     auto particles = getEntitiesByTag<ParticleSpriteComponent>();
-    for (const auto& [key, particle]: particles) {
-        auto particleComp = particle->getComponent<ParticleSpriteComponent>();
-        auto sprite = particleComp->sprite;
-        auto coords = particleComp->coords;
-        for (size_t i = 0; i < sprite->getSpritesCount(); ++i) {
-            sprite->setIdx(i);
-            render::drawTexture(*program, *sprite, coords[i].x,
-                               coords[i].y, coords[i].angle, 1.5f);
-        }
+    // Distance back to interpolated state in velocities
+    const GLfloat back = (1.f - m_alpha) * utils::physics::step_scale(m_step);
+    // Matrices are shared, so view is written by MoonLanderProgram
+    auto matrices = MoonLanderProgram::getInstance();
+    matrices->setView(m_view);
+    matrices->updateView();
+    program->bind();
+    for (auto particle: particles) {
+        auto particleComp = particle.getComponent<ParticleSpriteComponent>();
+        program->draw(*particleComp->sprite, particleComp->particles, back,
+                      m_scale);
     }
+    program->unbind();
 }
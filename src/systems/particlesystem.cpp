@@ -0,0 +1,58 @@
+#include "systems/particlesystem.hpp"
+#include "utils/utils.hpp"
+
+/**
+ * Put particles which fell under level back on its surface
+ * @param pool
+ * @param terrain
+ */
+static void collide_terrain(ParticlePool& pool, const Terrain& terrain)
+{
+    const GLfloat bounce = 0.3f;
+    const GLfloat friction = 0.6f;
+
+    auto& coords = pool.getCoords();
+    auto& vel = pool.getVel();
+    const GLfloat left = terrain.left();
+    const GLfloat right = terrain.right();
+    for (size_t i = 0; i < pool.size(); ++i) {
+        if (coords.x[i] <= left || coords.x[i] >= right)
+            continue;
+
+        const GLfloat alt = terrain.altitude(coords.x[i], coords.y[i]);
+        if (alt >= 0.f)
+            continue;
+
+        coords.y[i] += alt;
+        if (vel.y[i] > 0.f)
+            vel.y[i] = -vel.y[i] * bounce;
+        vel.x[i] *= friction;
+    }
+}
+
+ParticleSystem::ParticleSystem()
+{
+    reads<LevelComponent>();
+}
+
+void ParticleSystem::update_state(size_t delta)
+{
+    utils::ScopedProfile profile(m_counter);
+
+    auto levels = getEntitiesByTag<LevelComponent>();
+    const Terrain* terrain = nullptr;
+    if (!levels.empty())
+        terrain = &levels.front().getComponent<LevelComponent>()->terrain;
+
+    forEach<ParticleSpriteComponent>([delta, terrain](ParticleSpriteComponent& particle) {
+        if (particle.terrain_collision && terrain && !terrain->empty())
+            collide_terrain(particle.particles, *terrain);
+
+        particle.particles.expire(delta);
+    });
+}
+
+utils::ProfileCounter& ParticleSystem::getCounter() noexcept
+{
+    return m_counter;
+}
@@ -1,15 +1,13 @@
 #include "systems/physicssystem.hpp"
+#include "utils/utils.hpp"
 
 void PhysicsSystem::update_state(size_t delta)
 {
-    auto entities = getEntitiesByTag<VelocityComponent>();
-    for (auto& [key, en] : entities)
-        en->getComponent<VelocityComponent>()->y += gravity_force / weight;
-
-    auto particles = getEntitiesByTag<ParticleSpriteComponent>();
-    for (auto& [key, en] : particles) {
-        auto& vels = en->getComponent<ParticleSpriteComponent>()->vel;
-        for (auto& vel: vels)
-            vel.y += gravity_force / weight;
-    }
+    const GLfloat gravity = gravity_force / weight
+                            * utils::physics::step_scale(delta);
+    // Gravity of particles is applied by MovementSystem in the same
+    // pass as movement
+    parallelForEach<VelocityComponent>([gravity](VelocityComponent& vel) {
+        vel.y += gravity;
+    });
 }
@@ -15,44 +15,104 @@ using utils::log::Category;
 using glm::mat4;
 using glm::vec3;
 using glm::scale;
+using glm::mix;
+
+void RendererSystem::LevelBuffer::sync(const Terrain& terrain,
+                                       std::vector<vec2> LevelChunk::* data)
+{
+    auto end = [this]() {
+        return first + static_cast<std::ptrdiff_t>(counts.size());
+    };
+    auto pushBack = [&]() {
+        const auto& chunkData = terrain.chunk(end()).*data;
+        vertices.pushBack(chunkData.data(), chunkData.size());
+        counts.push_back(chunkData.size());
+    };
+
+    if (counts.empty() || terrain.firstIndex() >= end()
+        || terrain.endIndex() <= first) {
+        clear();
+        first = terrain.firstIndex();
+        while (end() < terrain.endIndex())
+            pushBack();
+        return;
+    }
+
+    for (; first < terrain.firstIndex(); ++first) {
+        vertices.popFront(counts.front());
+        counts.pop_front();
+    }
+    while (end() > terrain.endIndex()) {
+        vertices.popBack(counts.back());
+        counts.pop_back();
+    }
+    while (first > terrain.firstIndex()) {
+        const auto& chunkData = terrain.chunk(first - 1).*data;
+        vertices.pushFront(chunkData.data(), chunkData.size());
+        counts.push_front(chunkData.size());
+        --first;
+    }
+    while (end() < terrain.endIndex())
+        pushBack();
+}
+
+void RendererSystem::LevelBuffer::clear() noexcept
+{
+    vertices.clear();
+    counts.clear();
+}
 
 void RendererSystem::drawLevel()
 {
     auto levelEntities = getEntitiesByTag<LevelComponent>();
+    if (levelEntities.empty())
+        return;
+
+    auto en = levelEntities.front();
+    auto levelComp = en.getComponent<LevelComponent>();
+    if (en.getId() != m_level) { // New level, nothing of it is uploaded
+        m_level = en.getId();
+        m_points.clear();
+        m_stars.clear();
+        m_platforms.clear();
+    }
+    m_points.sync(levelComp->terrain, &LevelChunk::points);
+    m_stars.sync(levelComp->terrain, &LevelChunk::stars);
+    m_platforms.sync(levelComp->terrain, &LevelChunk::platforms);
+
     auto program = MoonLanderProgram::getInstance();
     program->setTextureRendering(false);
-    for (const auto& [key, en]: levelEntities) {
-        GLfloat scale_factor = en->getComponent<LevelComponent>()->scale_factor;
-        GLfloat invScale = 1.f / scale_factor;
-
-        glm::mat4 scaling = glm::scale(glm::mat4(1.f),
-                                       glm::vec3(scale_factor, scale_factor,1.f));
-        program->leftMultModel(scaling);
-        program->updateModel();
-
-        program->switchToPoints();
-        program->setColor(glm::vec4(1.f, 1.f, 1.f, 1.f));
-        program->updateColor();
-        render::drawDots(en->getComponent<LevelComponent>()->stars);
-
-        glLineWidth(1.f);
-        program->switchToLinesAdj();
-        program->setColor(glm::vec4(1.f, 1.f, 1.f, 1.f));
-        program->updateColor();
-        render::drawLinen(en->getComponent<LevelComponent>()->points, true);
-
-        glLineWidth(4.f);
-        program->switchToLines();
-        program->setColor(glm::vec4(1.f, 1.f, 1.f, 1.f));
-        program->updateColor();
-        render::drawLinen(en->getComponent<LevelComponent>()->platforms);
-
-        scaling[0][0] = invScale;
-        scaling[1][1] = invScale;
-        scaling[2][2] = invScale;
-        program->leftMultModel(scaling);
-        program->updateModel();
-    }
+    use_view(m_view);
+    GLfloat scale_factor = levelComp->scale_factor;
+    GLfloat invScale = 1.f / scale_factor;
+
+    glm::mat4 scaling = glm::scale(glm::mat4(1.f),
+                                   glm::vec3(scale_factor, scale_factor,1.f));
+    program->leftMultModel(scaling);
+    program->updateModel();
+
+    program->switchToPoints();
+    program->setColor(glm::vec4(1.f, 1.f, 1.f, 1.f));
+    program->updateColor();
+    m_stars.vertices.draw(GL_POINTS);
+
+    glLineWidth(1.f);
+    program->switchToLinesAdj();
+    program->setColor(glm::vec4(1.f, 1.f, 1.f, 1.f));
+    program->updateColor();
+    m_points.vertices.draw(GL_LINE_STRIP_ADJACENCY);
+
+    glLineWidth(4.f);
+    program->switchToLines();
+    program->setColor(glm::vec4(1.f, 1.f, 1.f, 1.f));
+    program->updateColor();
+    m_platforms.vertices.draw(GL_LINES);
+
+    scaling[0][0] = invScale;
+    scaling[1][1] = invScale;
+    scaling[2][2] = invScale;
+    program->leftMultModel(scaling);
+    program->updateModel();
 
     if (GLenum error = glGetError(); error != GL_NO_ERROR)
         throw GLException((format("\n\tRender while drawing level: %1%\n")
@@ -66,12 +126,20 @@ void RendererSystem::drawSprites()
     auto program = MoonLanderProgram::getInstance();
     program->switchToTriangles();
     program->setTextureRendering(true);
-    for (const auto& [key, en]: sprites) {
-        render::drawTexture(*program, *en->getComponent<SpriteComponent>()->sprite,
-                           en->getComponent<PositionComponent>()->x,
-                           en->getComponent<PositionComponent>()->y,
-                           en->getComponent<PositionComponent>()->angle,
-                           en->getComponent<PositionComponent>()->scale_factor);
+    // World sprites are drawn by camera, the others are fixed on screen
+    for (bool world: {true, false}) {
+        use_view(world ? m_view : mat4(1.f));
+        for (auto en: sprites) {
+            auto pos = en.getComponent<PositionComponent>();
+            if (pos->scallable != world)
+                continue;
+
+            render::drawTexture(*program, *en.getComponent<SpriteComponent>()->sprite,
+                               mix(pos->prev_x, pos->x, m_alpha),
+                               mix(pos->prev_y, pos->y, m_alpha),
+                               mix(pos->prev_angle, pos->angle, m_alpha),
+                               pos->scale_factor);
+        }
     }
     if (GLenum error = glGetError(); error != GL_NO_ERROR)
         throw GLException((format("\n\tRender while drawing level: %1%\n")
@@ -85,12 +153,15 @@ void RendererSystem::drawText()
     auto program = MoonLanderProgram::getInstance();
     program->switchToTriangles();
     program->setTextureRendering(true);
-    for (const auto& [key, en]: textComponents) {
-        render::drawTexture(*program, *en->getComponent<TextComponent>()->texture,
-                           en->getComponent<PositionComponent>()->x,
-                           en->getComponent<PositionComponent>()->y,
-                           en->getComponent<PositionComponent>()->angle,
-                           en->getComponent<PositionComponent>()->scale_factor);
+    // Text is part of interface, it doesn't move with camera
+    use_view(mat4(1.f));
+    for (auto en: textComponents) {
+        auto pos = en.getComponent<PositionComponent>();
+        render::drawTexture(*program, *en.getComponent<TextComponent>()->texture,
+                           mix(pos->prev_x, pos->x, m_alpha),
+                           mix(pos->prev_y, pos->y, m_alpha),
+                           mix(pos->prev_angle, pos->angle, m_alpha),
+                           pos->scale_factor);
     }
     if (GLenum error = glGetError(); error != GL_NO_ERROR)
         throw GLException((format("\n\tRender while drawing level: %1%\n")
@@ -105,7 +176,26 @@ void RendererSystem::update_state(size_t delta)
     drawText();
 }
 
-RendererSystem::RendererSystem()
+void RendererSystem::setInterpolation(GLfloat alpha)
+{
+    m_alpha = alpha;
+}
+
+void RendererSystem::setView(const glm::mat4& view)
+{
+    m_view = view;
+}
+
+void RendererSystem::use_view(const glm::mat4& view)
 {
+    auto program = MoonLanderProgram::getInstance();
+    program->setView(view);
+    program->updateView();
+}
 
+RendererSystem::RendererSystem()
+{
+    reads<SpriteComponent, LevelComponent>();
+    setMainThread();
+    setStage(render_stage);
 }
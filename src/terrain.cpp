@@ -0,0 +1,177 @@
+#include "terrain.hpp"
+
+void LevelChunk::buildIndex()
+{
+    assert(!points.empty());
+    assert(points.size() <= UINT16_MAX && "Segment doesn't fit to cell");
+
+    bounds.clear();
+    bounds.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const vec2& end = segmentEnd(i);
+        bounds.push_back({std::min(points[i].y, end.y),
+                          std::max(points[i].y, end.y)});
+    }
+
+    const GLfloat left = points.front().x;
+    const auto count = static_cast<size_t>(std::ceil((next.x - left) / cell_width));
+    cells.assign(std::max<size_t>(count, 1), 0);
+    size_t segment = 0;
+    for (size_t cell = 0; cell < cells.size(); ++cell) {
+        const GLfloat x = left + cell * cell_width;
+        while (segment + 1 < points.size() && segmentEnd(segment).x <= x)
+            ++segment;
+        cells[cell] = static_cast<std::uint16_t>(segment);
+    }
+}
+
+size_t LevelChunk::segmentAt(GLfloat x) const noexcept
+{
+    const GLfloat offset = std::max(x - points.front().x, 0.f);
+    const size_t cell = std::min(static_cast<size_t>(offset / cell_width),
+                                 cells.size() - 1);
+    size_t segment = cells[cell];
+    // Interior segments are wider than a cell, the walk from
+    // cells[cell] is bounded by a few steps
+    while (segment + 1 < points.size() && segmentEnd(segment).x <= x)
+        ++segment;
+
+    return segment;
+}
+
+bool Terrain::empty() const noexcept
+{
+    return m_chunks.empty();
+}
+
+size_t Terrain::size() const noexcept
+{
+    return m_chunks.size();
+}
+
+std::ptrdiff_t Terrain::firstIndex() const noexcept
+{
+    return m_first;
+}
+
+std::ptrdiff_t Terrain::endIndex() const noexcept
+{
+    return m_first + static_cast<std::ptrdiff_t>(m_chunks.size());
+}
+
+bool Terrain::contains(std::ptrdiff_t index) const noexcept
+{
+    return index >= m_first && index < endIndex();
+}
+
+const LevelChunk& Terrain::chunk(std::ptrdiff_t index) const
+{
+    assert(contains(index) && "Chunk isn't loaded");
+    return *m_chunks[index - m_first];
+}
+
+GLfloat Terrain::left() const
+{
+    assert(!empty());
+    return m_chunks.front()->points.front().x;
+}
+
+GLfloat Terrain::right() const
+{
+    assert(!empty());
+    return m_chunks.back()->next.x;
+}
+
+void Terrain::pushFront(LevelChunkPtr chunk)
+{
+    assert(chunk && !chunk->points.empty());
+    assert((empty() || chunk->index == m_first - 1)
+           && "Chunks must follow each other");
+    m_first = chunk->index;
+    m_chunks.push_front(std::move(chunk));
+}
+
+void Terrain::pushBack(LevelChunkPtr chunk)
+{
+    assert(chunk && !chunk->points.empty());
+    assert((empty() || chunk->index == endIndex())
+           && "Chunks must follow each other");
+    if (empty())
+        m_first = chunk->index;
+    m_chunks.push_back(std::move(chunk));
+}
+
+void Terrain::popFront()
+{
+    assert(!empty());
+    m_chunks.pop_front();
+    ++m_first;
+}
+
+void Terrain::popBack()
+{
+    assert(!empty());
+    m_chunks.pop_back();
+}
+
+void Terrain::clear() noexcept
+{
+    m_chunks.clear();
+    m_first = 0;
+}
+
+TerrainSegment Terrain::segment(GLfloat x) const
+{
+    const std::ptrdiff_t index = std::clamp(chunkIndex(x), m_first,
+                                            endIndex() - 1);
+    return {index, chunk(index).segmentAt(x)};
+}
+
+GLfloat Terrain::interpolate(const TerrainSegment& segment, GLfloat x) const
+{
+    const LevelChunk& cur = chunk(segment.chunk);
+    const vec2& p = cur.points[segment.segment];
+    const vec2& q = cur.segmentEnd(segment.segment);
+    if (q.x == p.x)
+        return p.y;
+
+    return (x - p.x) / (q.x - p.x) * (q.y - p.y) + p.y;
+}
+
+GLfloat Terrain::height(GLfloat x) const
+{
+    assert(!empty());
+    x = std::clamp(x, left(), right());
+    return interpolate(segment(x), x);
+}
+
+GLfloat Terrain::height(GLfloat x, TerrainSegment& hint) const
+{
+    assert(!empty());
+    x = std::clamp(x, left(), right());
+
+    // Check hinted segment and its neighbours before searching
+    if (contains(hint.chunk)) {
+        const LevelChunk& cur = chunk(hint.chunk);
+        const size_t first = hint.segment > 0 ? hint.segment - 1 : 0;
+        const size_t last = std::min(hint.segment + 1, cur.points.size() - 1);
+        for (size_t i = first; i <= last; ++i)
+            if (cur.points[i].x <= x && x <= cur.segmentEnd(i).x) {
+                hint.segment = i;
+                return interpolate(hint, x);
+            }
+    }
+
+    hint = segment(x);
+    return interpolate(hint, x);
+}
+
+GLfloat Terrain::altitude(GLfloat x, GLfloat y) const
+{
+    return height(x) - y;
+}
+
+GLfloat Terrain::altitude(GLfloat x, GLfloat y, TerrainSegment& hint) const
+{
+    return height(x, hint) - y;
+}
@@ -0,0 +1,78 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <boost/format.hpp>
+
+#include "utils/inputscript.hpp"
+#include "exceptions/fsexception.hpp"
+
+using boost::format;
+
+utils::InputScript::InputScript(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw FSException((format("Can't open input script %1%\n") % path).str(),
+                          program_log_file_name(), Category::FILE_ERROR);
+
+    std::string line;
+    size_t lineNum = 0;
+    while (std::getline(file, line)) {
+        ++lineNum;
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream input(line);
+        size_t step;
+        std::string keys;
+        if (!(input >> step >> keys))
+            throw BaseGameException((format("Wrong line %1% of input script %2%\n")
+                                     % lineNum % path).str());
+
+        add(step, keys);
+    }
+}
+
+void utils::InputScript::add(size_t step, const std::string& keys)
+{
+    if (!m_entries.empty() && m_entries.back().step >= step)
+        throw BaseGameException((format("Step %1% of input script "
+                                        "doesn't increase\n") % step).str());
+
+    Entry entry{step, false, false, false};
+    for (char key: keys) {
+        switch (key) {
+            case 'U': entry.up = true; break;
+            case 'L': entry.left = true; break;
+            case 'R': entry.right = true; break;
+            case '-': break;
+            default:
+                throw BaseGameException((format("Unknown key %1% in input "
+                                                "script\n") % key).str());
+        }
+    }
+
+    m_entries.push_back(entry);
+}
+
+utils::InputScript::Controls utils::InputScript::controls(size_t step) const noexcept
+{
+    // The last entry which started not later than step
+    auto it = std::upper_bound(m_entries.cbegin(), m_entries.cend(), step,
+                               [](size_t step, const Entry& entry) {
+                                   return step < entry.step;
+                               });
+    if (it == m_entries.cbegin())
+        return {};
+
+    --it;
+    return {it->up, it->left, it->right};
+}
+
+void utils::InputScript::apply(size_t step, Uint8* keys) const noexcept
+{
+    const Controls held = controls(step);
+    keys[SDL_SCANCODE_UP] = held.up;
+    keys[SDL_SCANCODE_LEFT] = held.left;
+    keys[SDL_SCANCODE_RIGHT] = held.right;
+}
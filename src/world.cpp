@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <glm/gtc/constants.hpp>
 #include <boost/format.hpp>
@@ -15,9 +17,13 @@
 #include "systems/keyboardsystem.hpp"
 #include "systems/animationsystem.hpp"
 #include "systems/collisionsystem.hpp"
+#include "systems/landersystem.hpp"
 #include "systems/physicssystem.hpp"
 #include "particle/particleengine.hpp"
 #include "systems/particlerendersystem.hpp"
+#include "systems/particlesystem.hpp"
+#include "systems/emittersystem.hpp"
+#include "components/emittercomponent.hpp"
 #include "utils/random.hpp"
 #include "components/lifetimecomponent.hpp"
 #include "game.hpp"
@@ -27,17 +33,11 @@ using utils::log::Logger;
 using utils::getResourcePath;
 using utils::log::program_log_file_name;
 using boost::format;
-using utils::physics::altitude;
 using std::floor;
 using std::vector;
 using std::make_shared;
-using std::sin;
-using std::cos;
-using glm::half_pi;
 using std::find_if;
 using glm::pi;
-using utils::fix_coords;
-using ecs::types::type_id;
 
 const int SHIP_WIDTH = 20;
 const int SHIP_HEIGHT = 21;
@@ -52,145 +52,117 @@ const char* const msgFont = "kenvector_future2.ttf";
 const SDL_Color fontColor = {0xFF, 0xFF, 0xFF, 0xFF};
 
 const GLfloat ship_init_alt = 500;
+// Horizontal distance between landers of headless world
+const GLfloat lander_spacing = 50.f;
 
-const size_t ship_id =          0;
-const size_t level_id =         1;
-const size_t ship_particle_id = 2;
-const size_t fps_id =           3;
-const size_t velx_id = 		4;
-const size_t vely_id = 		5;
-const size_t alt_id = 		6;
-const size_t fuel_id =		7;
-const size_t time_id =		8;
-const size_t earth_id =         9;
-const size_t fail_id =          10;
-const size_t win_id =           11;
+// Debris of several explosions fit into pool, older ones are recycled
+const size_t debris_pool_size = 4 * 4 * 8;
+const GLfloat debris_life_time = 10000000.f; // microseconds
+
+// Engine exhaust: particles per second and their life time. Pool
+// holds all particles alive at once
+const GLfloat exhaust_rate = 3000.f;
+const GLfloat exhaust_life_time = 400000.f; // microseconds
+const size_t exhaust_pool_size = 2048;
+const GLfloat exhaust_speed = 3.f;
+const GLfloat exhaust_spread = 0.2f;
 
 void World::rescale_world()
 {
     m_frameWidth = m_scaled ? m_screenWidth : (m_screenWidth / m_scaleFactor);
     m_frameHeight = m_scaled ? m_screenHeight : (m_screenHeight / m_scaleFactor);
 
-    auto levelEnt = m_entities[level_id];
-    levelEnt->getComponent<LevelComponent>()->scale_factor = m_scaled ?
+    auto levelEnt = getEntity(m_level);
+    levelEnt.getComponent<LevelComponent>()->scale_factor = m_scaled ?
                                                           1.f : m_scaleFactor;
 
-    if (m_entities.count(ship_id) != 0) {
-        auto ship = m_entities[ship_id];
-        size_t idx = type_id<RendererSystem>;
-        auto renderSystem = std::dynamic_pointer_cast<RendererSystem>(
-                m_systems[idx]);
-        auto shipPos = ship->getComponent<PositionComponent>();
-        auto scaled_entities = renderSystem->getEntitiesByTag<PositionComponent>();
-        for (auto&[key, en]: scaled_entities) {
-            auto pos = en->getComponent<PositionComponent>();
-            if (pos->scallable)
-                pos->scale_factor = m_scaled ? 1.f : m_scaleFactor;
-        }
-
-        m_camera.lookAt(shipPos->x + m_camera.getX() - m_frameWidth / 2.f,
-                        shipPos->y + m_camera.getY()
-                        - m_frameWidth / (m_scaled ? 5.f : 4.f));
+    if (isValid(m_ship)) {
+        auto ship = getEntity(m_ship);
+        auto shipPos = ship.getComponent<PositionComponent>();
+        const GLfloat scale = m_scaled ? 1.f : m_scaleFactor;
+        getStorage().each<PositionComponent>([scale](PositionComponent& pos) {
+            if (pos.scallable)
+                pos.scale_factor = scale;
+        });
+
+        m_camera.lookAt(shipPos->x - m_frameWidth / 2.f,
+                        shipPos->y - m_frameWidth / (m_scaled ? 5.f : 4.f));
     }
 
     m_scaled = !m_scaled;
-    update_movables();
+    // Jump of scale isn't interpolated
+    save_state();
 }
 
-void World::update_ship()
+void World::update_ship(size_t delta)
 {
-    using utils::physics::altitude;
+    using utils::physics::step_scale;
     using utils::Position;
 
-    auto ship = m_entities[ship_id];
-    auto shipPos = ship->getComponent<PositionComponent>();
-    auto shipVel = ship->getComponent<VelocityComponent>();
+    auto ship = getEntity(m_ship);
+    auto shipPos = ship.getComponent<PositionComponent>();
+    auto shipVel = ship.getComponent<VelocityComponent>();
 
-    auto renderSystem = std::dynamic_pointer_cast<RendererSystem>(
-            m_systems[type_id<RendererSystem>]
-    );
-    auto levelComp = m_entities[level_id]->getComponent<LevelComponent>();
-    GLfloat shipAlt = altitude(levelComp->points, shipPos->x, shipPos->y);
+    auto colShip = ship.getComponent<CollisionComponent>();
+    GLfloat shipAlt = colShip->altitude;
     const GLfloat alt_threshold = 100.f; // Threshold when world will be scaled
     if ((shipAlt < alt_threshold && !m_scaled) // Need to increase scale
         || (shipAlt >= alt_threshold && m_scaled)) { // Need to decrease scale
         rescale_world();
     }
 
-    if ((shipPos->x >= m_frameWidth - m_frameWidth / 4.f)
-        || (shipPos->x < m_frameWidth / 4.f)) { // Horizontal edges
-        m_camera.translate(shipVel->x, 0.f);
-        update_movables();
-    }
+    // Position of ship in frame
+    const GLfloat frameX = shipPos->x - m_camera.getX();
+    const GLfloat frameY = shipPos->y - m_camera.getY();
+    if ((frameX >= m_frameWidth - m_frameWidth / 4.f)
+        || (frameX < m_frameWidth / 4.f)) // Horizontal edges
+        m_camera.translate(shipVel->x * step_scale(delta), 0.f);
+
+    if ((frameY >= m_frameHeight - m_frameHeight / 4.f)
+        || (frameY < m_frameHeight / 4.f)) // Vertical edges
+        m_camera.translate(0.f, shipVel->y * step_scale(delta));
+
+    // Landing is checked by LanderSystem, headless world runs
+    // till the last lander finishes
+    const LanderState state = ship.getComponent<LanderComponent>()->state;
+    if (state == LanderState::FLYING || getGameState() != GameStates::NORMAL
+        || m_headless)
+        return;
 
-    if ((shipPos->y >= m_frameHeight - m_frameHeight / 4.f)
-               || (shipPos->y < m_frameHeight / 4.f)) { // Vertical edges
-        m_camera.translate(0.f, shipVel->y);
-        update_movables();
+    if (state == LanderState::LANDED) {
+        setGameState(GameStates::WIN);
+    } else {
+        explode_ship();
+        ship.kill();
+        setGameState(GameStates::FAIL);
     }
 
-    auto colShip = ship->getComponent<CollisionComponent>();
-    if (colShip->has_collision) {
-        const vector<vec2>& platforms = levelComp->platforms;
-        bool landed = false;
-        assert(platforms.size() % 2 == 0);
-        GLfloat angle = shipPos->angle -
-                        glm::two_pi<GLfloat>()
-                        * std::floor(shipPos->angle / glm::two_pi<GLfloat>());
-        GLfloat crit_angle = glm::pi<GLfloat>() / 6.f;
-        if (((angle >= -crit_angle && angle <= crit_angle)
-             || (angle >= glm::two_pi<GLfloat>() - crit_angle))
-            && std::abs(shipVel->y * 60.f) <= 20) {
-            const GLfloat pad = 2;
-            utils::Rect shipSize = ship->getComponent<SpriteComponent>()->sprite->getCurrentClip();
-            for (size_t i = 0; i < platforms.size() - 1; i += 2) {
-                GLfloat left_bound = platforms[i].x;
-                GLfloat right_bound = platforms[i + 1].x;
-                if (shipPos->x >= left_bound - pad
-                    && shipPos->x <= right_bound + pad
-                    && shipPos->x + shipSize.w <= right_bound + pad) {
-                    shipVel->x = shipVel->y = shipVel->angle = 0;
-                    landed = true;
-                    setGameState(GameStates::WIN);
-                    break;
-                }
-            }
-        }
-
-        if (!landed) {
-            utils::Rect shipClip{0, 32, SHIP_WIDTH, SHIP_HEIGHT};
-            vector<Position> coords(16, {shipPos->x, shipPos->y, shipPos->angle});
-            vector<Position> vel(16, {shipVel->x, shipVel->y, shipVel->angle});
-
-            utils::Random rand;
-            // Init velocities of particles
-            std::generate(vel.begin(), vel.end(), [&rand, shipVel]() {
-                const GLfloat deviation = 1.5f;
-                const GLfloat scale_vel = 20.f;
-                const GLfloat scale_vel_rot = 30.f;
-                return utils::Position {
-                        rand.generaten(shipVel->x / scale_vel, deviation),
-                        rand.generaten(shipVel->y / scale_vel, deviation),
-                        rand.generaten(shipVel->angle / scale_vel_rot, deviation)
-                };
-            });
-
-            auto particle = ParticleEngine::generateFromTexture<4 * 4>(
-                    utils::getResourcePath("lunar_lander_bw.png"),
-                    generate_clips<4, 4>(shipClip), coords, vel, 10000.f);
-
-            m_entities.emplace(ship_particle_id, particle);
-
-            ship->kill();
-
-            if (!m_audio.isChannelPlaying(crash_sound_channel))
-                m_audio.playChunk(crash_sound_channel, crash_idx, 0, false);
-
-            setGameState(GameStates::FAIL);
-        }
+    m_audio.haltChannel(engine_channel, true);
+}
 
-        m_audio.haltChannel(engine_channel, true);
+void World::explode_ship()
+{
+    auto ship = getEntity(m_ship);
+    auto shipPos = ship.getComponent<PositionComponent>();
+    auto shipVel = ship.getComponent<VelocityComponent>();
+    auto debris = getEntity(m_shipParticle).getComponent<ParticleSpriteComponent>();
+
+    utils::Random rand;
+    // Each fragment of ship is one clip of debris sprite
+    for (GLuint clip = 0; clip < 4 * 4; ++clip) {
+        const GLfloat deviation = 1.5f;
+        const GLfloat scale_vel = 20.f;
+        const GLfloat scale_vel_rot = 30.f;
+        debris->particles.spawn(
+                {shipPos->x, shipPos->y, shipPos->angle},
+                {rand.generaten(shipVel->x / scale_vel, deviation),
+                 rand.generaten(shipVel->y / scale_vel, deviation),
+                 rand.generaten(shipVel->angle / scale_vel_rot, deviation)},
+                clip);
     }
+
+    if (!m_audio.isChannelPlaying(crash_sound_channel))
+        m_audio.playChunk(crash_sound_channel, crash_idx, 0, false);
 }
 
 void World::update_level()
@@ -198,75 +170,78 @@ void World::update_level()
     if (getGameState() != GameStates::NORMAL)
         return;
 
-    auto ship = m_entities[ship_id];
-    const auto shipPos = ship->getComponent<PositionComponent>();
-
-    vec2 shipCoords = fix_coords({shipPos->x, shipPos->y},
-                                 {m_camera.getX() + m_realCamX, m_camera.getY()});
-    vec2 levelBorder = {level.max_left, level.max_right};
-    bool nearLeft = shipCoords.x <= (levelBorder.x + m_screenWidth);
-    bool nearRight = shipCoords.x >= (levelBorder.y - m_screenWidth);
-
-    std::shared_ptr<Entity> levelEnt;
-    std::shared_ptr<LevelComponent> levelComp;
-    if (nearLeft || nearRight) {
-        levelEnt = m_entities[level_id];
-        levelComp = levelEnt->getComponent<LevelComponent>();
+    // Level is needed under flying landers, it is prefetched
+    // in direction of their average motion
+    GLfloat left = std::numeric_limits<GLfloat>::max();
+    GLfloat right = std::numeric_limits<GLfloat>::lowest();
+    GLfloat velX = 0.f;
+    for (auto id: m_landers) {
+        if (!isValid(id))
+            continue;
+
+        const auto lander = getEntity(id);
+        if (lander.getComponent<LanderComponent>()->state != LanderState::FLYING)
+            continue;
+
+        const GLfloat x = lander.getComponent<PositionComponent>()->x;
+        left = std::min(left, x);
+        right = std::max(right, x);
+        velX += lander.getComponent<VelocityComponent>()->x;
     }
 
-    if (nearLeft) { // TODO: there is a bug: coordinate y jump when level extends
-        level.extendToLeft(m_camera);
-        levelComp->points = level.points;
-        levelComp->platforms = level.platforms;
-        levelComp->stars = level.stars;
-    } else if (nearRight) {
-        level.extendToRight(m_camera);
-        levelComp->points = level.points;
-        levelComp->platforms = level.platforms;
-        levelComp->stars = level.stars;
-    }
+    if (left <= right)
+        load_level(left, right, (velX > 0.f) - (velX < 0.f));
+}
 
-    //bool nearUp = shipCoords.y <= (level.stars.back().y + m_screenWidth);
-    //if (nearUp) {
-    //}
+void World::load_level(GLfloat left, GLfloat right, int direction)
+{
+    // Chunks within screen width from [left, right] are needed
+    auto& terrain = getEntity(m_level).getComponent<LevelComponent>()->terrain;
+    m_levelLoader.load(terrain, Terrain::chunkIndex(left - m_screenWidth),
+                       Terrain::chunkIndex(right + m_screenWidth), direction);
 }
 
 void World::update_text()
 {
     if constexpr (debug) {
-        auto fpsEntity = m_entities[fps_id];
-        auto textFps = fpsEntity->getComponent<TextComponent>();
+        auto textFps = getEntity(m_fpsText).getComponent<TextComponent>();
         textFps->texture->setText((format("FPS: %+3d") % m_fps.get_fps()).str());
-    }
 
-    auto velxEntity = m_entities[velx_id];
-    auto velyEntity = m_entities[vely_id];
-    auto altEntity = m_entities[alt_id];
-    auto fuelEntity = m_entities[fuel_id];
-    auto timeEntity = m_entities[time_id];
+        // Average over about a second of steps
+        auto& emitCounter = m_emitter->getCounter();
+        auto& simCounter = m_particleSystem->getCounter();
+        if (simCounter.getCalls() >= sim_tick_rate) {
+            const auto exhaust = getEntity(m_exhaust).getComponent<ParticleSpriteComponent>();
+            auto textParticles = getEntity(m_particlesText).getComponent<TextComponent>();
+            textParticles->texture->setText(
+                    (format("Particles: %4d emit: %5.1fus sim: %5.1fus")
+                     % exhaust->particles.size() % emitCounter.getAverage()
+                     % simCounter.getAverage()).str());
+            emitCounter.reset();
+            simCounter.reset();
+        }
+    }
 
-    auto textVelX = velxEntity->getComponent<TextComponent>();
-    auto textVelY = velyEntity->getComponent<TextComponent>();
-    auto textAlt = altEntity->getComponent<TextComponent>();
-    auto textFuel = fuelEntity->getComponent<TextComponent>();
-    auto textTime = timeEntity->getComponent<TextComponent>();
+    auto textVelX = getEntity(m_velX).getComponent<TextComponent>();
+    auto textVelY = getEntity(m_velY).getComponent<TextComponent>();
+    auto textAlt = getEntity(m_alt).getComponent<TextComponent>();
+    auto textFuel = getEntity(m_fuel).getComponent<TextComponent>();
+    auto textTime = getEntity(m_time).getComponent<TextComponent>();
 
     if (getGameState() == GameStates::NORMAL
         || getGameState() == GameStates::WIN) {
-        const auto shipEntity = m_entities[ship_id];
-        const auto points = m_entities[level_id]->getComponent<LevelComponent>()->points;
+        const auto shipEntity = getEntity(m_ship);
 
-        const auto shipVel = shipEntity->getComponent<VelocityComponent>();
-        const auto shipPos = shipEntity->getComponent<PositionComponent>();
-        const auto fuel = shipEntity->getComponent<LifeTimeComponent>();
+        const auto shipVel = shipEntity.getComponent<VelocityComponent>();
+        const auto shipCol = shipEntity.getComponent<CollisionComponent>();
+        const auto fuel = shipEntity.getComponent<LifeTimeComponent>();
 
         textVelX->texture->setText((format("Horizontal speed: %5d") %
                                     floor(shipVel->x * 60.f)).str());
         textVelY->texture->setText((format("Vertical speed: %5d") %
                                     floor(-shipVel->y * 60.f)).str());
         textAlt->texture->setText((format("Altitude: %5d") %
-                                   floor(altitude(points, shipPos->x, shipPos->y)
-                                         - SHIP_HEIGHT)).str());
+                                   floor(shipCol->altitude - SHIP_HEIGHT)).str());
         textFuel->texture->setText((format("Fuel: %5d") % fuel->time).str());
         textTime->texture->setText((format("Time: %5f")
                                     % (m_timer.getTicks() / 1000.f)).str());
@@ -276,12 +251,13 @@ void World::update_text()
             m_timer.pause();
 
         if (getGameState() == GameStates::WIN
-            && m_entities.count(win_id) == 0) {
-            auto winText = createEntity(win_id);
-            winText->addComponents<TextComponent, PositionComponent>();
-            winText->activate();
+            && !isValid(m_win)) {
+            auto winText = createEntity();
+            m_win = winText.getId();
+            winText.addComponents<TextComponent, PositionComponent>();
+            winText.activate();
 
-            auto winTextTexture = winText->getComponent<TextComponent>();
+            auto winTextTexture = winText.getComponent<TextComponent>();
             TTF_Font* font = open_font(msgFont, 14);
             GLfloat score = fuel->time * 1.f / m_timer.getTicks() * 1000.f;
             std::string winMsg = (format("You landed\nScore is %.3f\n"
@@ -290,7 +266,7 @@ void World::update_text()
             winTextTexture->texture =
                     make_shared<TextTexture>(winMsg, font, fontColor);
 
-            auto winTextPos = winText->getComponent<PositionComponent>();
+            auto winTextPos = winText.getComponent<PositionComponent>();
             winTextPos->x = m_screenWidth / 2.f
                             - winTextTexture->texture->getWidth() / 2.f;
             winTextPos->y = m_screenHeight / 2.f
@@ -298,22 +274,23 @@ void World::update_text()
             winTextPos->scallable = false;
         }
     } else if (getGameState() == GameStates::FAIL
-               && m_entities.count(fail_id) == 0) { // Fail case
+               && !isValid(m_fail)) { // Fail case
         textVelX->texture->setText((format("Horizontal speed: %3d") % 0).str());
         textVelY->texture->setText((format("Vertical speed: %3d") % 0).str());
 
-        auto failText = createEntity(fail_id);
-        failText->addComponents<TextComponent, PositionComponent>();
-        failText->activate();
+        auto failText = createEntity();
+        m_fail = failText.getId();
+        failText.addComponents<TextComponent, PositionComponent>();
+        failText.activate();
 
-        auto failTextTexture = failText->getComponent<TextComponent>();
+        auto failTextTexture = failText.getComponent<TextComponent>();
         TTF_Font* font = open_font(msgFont, 14);
         failTextTexture->texture =
                 make_shared<TextTexture>("You fail\n"
                                          "To play again press Enter", font,
                                          fontColor);
 
-        auto failTextPos = failText->getComponent<PositionComponent>();
+        auto failTextPos = failText.getComponent<PositionComponent>();
         failTextPos->x = m_screenWidth / 2.f
                          - failTextTexture->texture->getWidth() / 2.f;
         failTextPos->y = m_screenHeight / 2.f
@@ -324,86 +301,210 @@ void World::update_text()
 
 void World::update(size_t delta)
 {
-    if constexpr (debug)
-        m_fps.update();
+    const ecs::Tick stepStart = getStorage().getTick();
+    save_state();
+
+    // Landed lander is held by LanderSystem, so world isn't stopped
+    m_landerSystem->setStep(m_steps);
+    ++m_steps;
 
     if (getGameState() == GameStates::WIN
-        && getPrevGameState() != GameStates::WIN) {
-        m_systems[type_id<MovementSystem>]->stop();
-        m_entities[ship_id]->removeComponent<KeyboardComponent>();
-    }
+        && getPrevGameState() != GameStates::WIN && !m_headless)
+        getEntity(m_ship).removeComponent<KeyboardComponent>();
 
     if (getGameState() == GameStates::NORMAL
         || getGameState() == GameStates::WIN)
-        update_ship();
+        update_ship(delta);
 
-    update_text();
     update_level();
 
-    filter_entities();
-    for (auto &system: m_systems)
-        system.second->update(delta);
+    flushCommands();
+    updateSystems(delta, simulation_stage);
+    snap_positions(stepStart);
+}
+
+void World::render(GLfloat alpha, size_t step)
+{
+    assert(!m_headless && "Headless world can't be rendered");
+
+    if constexpr (debug)
+        m_fps.update();
+
+    const ecs::Tick textStart = getStorage().getTick();
+    update_text();
+    snap_positions(textStart);
+
+    const GLfloat scale = getEntity(m_level).getComponent<LevelComponent>()
+            ->scale_factor;
+    const glm::mat4 view = m_camera.getView(alpha, scale);
+    m_renderer->setInterpolation(alpha);
+    m_renderer->setView(view);
+    m_particleRenderer->setInterpolation(alpha, step);
+    m_particleRenderer->setView(view, scale);
+    updateSystems(step, render_stage);
+}
+
+void World::setInputScript(const utils::InputScript* script) noexcept
+{
+    m_input = script;
+}
+
+void World::setSeed(std::uint64_t seed) noexcept
+{
+    level.seed = seed;
+}
+
+size_t World::getSteps() const noexcept
+{
+    return m_steps;
+}
+
+void World::setLanders(size_t count) noexcept
+{
+    assert(m_headless && count > 0 && "Only headless world has several landers");
+    m_landerCount = count;
+}
+
+size_t World::getLanders() const noexcept
+{
+    return m_landers.size();
+}
+
+LanderComponent World::getLander(size_t idx)
+{
+    assert(idx < m_landers.size());
+    // Crashed ship is destroyed
+    if (!isValid(m_landers[idx]))
+        return {};
+
+    return *getEntity(m_landers[idx]).getComponent<LanderComponent>();
+}
+
+bool World::isFlying()
+{
+    return std::any_of(m_landers.cbegin(), m_landers.cend(), [this](ecs::EntityId id) {
+        return isValid(id) && getEntity(id).getComponent<LanderComponent>()->state
+                              == LanderState::FLYING;
+    });
+}
+
+GLfloat World::getFuel(size_t idx)
+{
+    assert(idx < m_landers.size());
+    if (!isValid(m_landers[idx]))
+        return 0.f;
+
+    return getEntity(m_landers[idx]).getComponent<LifeTimeComponent>()->time;
+}
+
+void World::save_state()
+{
+    getStorage().each<PositionComponent>([](PositionComponent& pos) {
+        pos.prev_x = pos.x;
+        pos.prev_y = pos.y;
+        pos.prev_angle = pos.angle;
+    });
+
+    m_camera.save();
+}
+
+void World::snap_positions(ecs::Tick since)
+{
+    // Entities which were added after since have no previous state
+    getStorage().each<ecs::Write<PositionComponent>, ecs::Added<PositionComponent>>(
+            [](PositionComponent& pos, const PositionComponent&) {
+                pos.prev_x = pos.x;
+                pos.prev_y = pos.y;
+                pos.prev_angle = pos.angle;
+            }, since - 1, getStorage().getTick());
 }
 
 void World::init()
 {
-    //TODO: fix this
-    level.height_min = utils::getScreenHeight<GLfloat>()
-                       - utils::getScreenHeight<GLfloat>() / 2.f;
-    level.height_max = utils::getScreenHeight<GLfloat>();
+    m_steps = 0;
+    m_keys.fill(0);
 
     if (!m_wasInit) {
-        m_screenWidth = utils::getScreenWidth<GLuint>();
-        m_screenHeight = utils::getScreenHeight<GLuint>();
+        m_screenWidth = m_headless ? headless_screen_width
+                                   : utils::getScreenWidth<GLuint>();
+        m_screenHeight = m_headless ? headless_screen_height
+                                    : utils::getScreenHeight<GLuint>();
         m_frameWidth = m_screenWidth;
         m_frameHeight = m_screenHeight;
 
-        createSystem<RendererSystem>();
+        //TODO: fix this
+        level.height_min = m_screenHeight - m_screenHeight / 2.f;
+        level.height_max = m_screenHeight;
+        m_levelLoader.start(level);
+
+        // Headless world has only simulation systems
+        if (!m_headless)
+            m_renderer = &createSystem<RendererSystem>();
         createSystem<MovementSystem>();
-        createSystem<KeyboardSystem>();
-        createSystem<AnimationSystem>();
+        auto& keyboard = createSystem<KeyboardSystem>();
+        if (!m_headless)
+            createSystem<AnimationSystem>();
         createSystem<CollisionSystem>();
         createSystem<PhysicsSystem>();
-        createSystem<ParticleRenderSystem>();
+        // Velocity of finished landers is reset after gravity
+        m_landerSystem = &createSystem<LanderSystem>();
+        if (!m_headless)
+            m_emitter = &createSystem<EmitterSystem>();
+        m_particleSystem = &createSystem<ParticleSystem>();
+        if (!m_headless)
+            m_particleRenderer = &createSystem<ParticleRenderSystem>();
+        else
+            keyboard.setKeyboardState(m_keys.data());
 
         // Order of initialization is matter
         init_level();
+        if (!m_headless)
+            init_particles();
         init_ship();
-        init_sprites();
-        init_text();
-        init_sound();
-
-        m_nonStatic[level_id] = m_entities[level_id];
-        m_nonStatic[ship_id] = m_entities[ship_id];
+        init_landers();
+        if (!m_headless) {
+            init_sprites();
+            init_text();
+            init_sound();
+        }
 
-        auto shipPos = m_entities[ship_id]->getComponent<PositionComponent>();
+        auto shipPos = getEntity(m_ship).getComponent<PositionComponent>();
         m_camera.lookAt(shipPos->x - m_screenWidth / 2.f,
                         shipPos->y - m_screenHeight / 2.f);
-        update_movables();
 
         m_wasInit = true;
     } else {
-        m_entities.erase(win_id);
-        m_entities.erase(fail_id);
-        m_entities.erase(ship_id);
-        m_entities.erase(ship_particle_id);
-        m_systems[type_id<MovementSystem>]->start();
+        for (auto id: {m_win, m_fail})
+            if (isValid(id))
+                destroyEntity(id);
+        for (auto id: m_landers)
+            if (isValid(id))
+                destroyEntity(id);
+        // Pools are kept for the next flight
+        for (auto id: {m_shipParticle, m_exhaust})
+            if (isValid(id))
+                getEntity(id).getComponent<ParticleSpriteComponent>()
+                        ->particles.clear();
 
         rescale_world();
+        // Landers start at the same place, level there could be evicted
+        load_level(m_screenWidth / 2.f, m_screenWidth / 2.f
+                                        + lander_spacing * (m_landerCount - 1));
         init_ship();
-        
-        m_nonStatic[ship_id] = m_entities[ship_id];
-        m_realCamX += m_camera.getX();
-        m_camera.lookAt(0.f, 0.f); // reset camera
-        update_movables();
+        init_landers();
 
-        auto shipPos = m_entities[ship_id]->getComponent<PositionComponent>();
+        auto shipPos = getEntity(m_ship).getComponent<PositionComponent>();
 
         m_camera.lookAt(shipPos->x - m_screenWidth / 2.f,
                         shipPos->y - m_screenHeight / 2.f);
-        update_movables();
     }
 
+    // Camera jumps aren't interpolated
+    save_state();
+
+    if (m_headless)
+        return;
+
     if (m_timer.isStarted() || m_timer.isPaused())
         m_timer.stop();
 
@@ -425,18 +526,19 @@ void World::init_sprites()
 {
     using namespace utils::physics;
 
-    auto earth = createEntity(earth_id);
-    earth->addComponents<PositionComponent, SpriteComponent>();
-    earth->activate();
+    auto earth = createEntity();
+    m_earth = earth.getId();
+    earth.addComponents<PositionComponent, SpriteComponent>();
+    earth.activate();
 
-    auto earthSprite = earth->getComponent<SpriteComponent>();
+    auto earthSprite = earth.getComponent<SpriteComponent>();
     const std::string earthPath = "lunar_lander_bw.png";
     earthSprite->sprite = make_shared<Sprite>(
             utils::getResourcePath(earthPath));
     earthSprite->sprite->addClipSprite({200, 77, 40, 33});
     earthSprite->sprite->generateDataBuffer();
 
-    auto earthPos = earth->getComponent<PositionComponent>();
+    auto earthPos = earth.getComponent<PositionComponent>();
     earthPos->x = m_screenWidth / 10.f;
     earthPos->y = m_screenHeight / 10.f;
     earthPos->scallable = false;
@@ -446,91 +548,113 @@ void World::init_text()
 {
     if constexpr (debug) {
         // Fps entity
-        auto fpsText = createEntity(fps_id);
-        fpsText->addComponents<TextComponent, PositionComponent>();
-        fpsText->activate();
+        auto fpsText = createEntity();
+        m_fpsText = fpsText.getId();
+        fpsText.addComponents<TextComponent, PositionComponent>();
+        fpsText.activate();
 
-        auto fspTexture = fpsText->getComponent<TextComponent>();
+        auto fspTexture = fpsText.getComponent<TextComponent>();
         TTF_Font *font = open_font(msgFont, 14);
         fspTexture->texture = make_shared<TextTexture>("FPS: 000", font,
                                                        fontColor);
 
-        auto fpsPos = fpsText->getComponent<PositionComponent>();
+        auto fpsPos = fpsText.getComponent<PositionComponent>();
         fpsPos->x = m_screenWidth - m_screenWidth / 4.2f;
         fpsPos->y = m_screenHeight / 15.f;
         fpsPos->scallable = false;
+
+        // Number of particles and time of their emission and simulation
+        auto particlesText = createEntity();
+        m_particlesText = particlesText.getId();
+        particlesText.addComponents<TextComponent, PositionComponent>();
+        particlesText.activate();
+
+        auto particlesTexture = particlesText.getComponent<TextComponent>();
+        particlesTexture->texture = make_shared<TextTexture>(
+                "Particles: 0000 emit: 000.0us sim: 000.0us",
+                open_font(msgFont, 14), fontColor);
+
+        auto particlesPos = particlesText.getComponent<PositionComponent>();
+        particlesPos->x = m_screenWidth - m_screenWidth / 4.2f;
+        particlesPos->y = m_screenHeight / 5.f;
+        particlesPos->scallable = false;
     }
 
     // Velocity x entity
-    auto velxText = createEntity(velx_id);
-    velxText->addComponents<TextComponent, PositionComponent>();
-    velxText->activate();
+    auto velxText = createEntity();
+    m_velX = velxText.getId();
+    velxText.addComponents<TextComponent, PositionComponent>();
+    velxText.activate();
 
-    auto velxTexture = velxText->getComponent<TextComponent>();
+    auto velxTexture = velxText.getComponent<TextComponent>();
     TTF_Font *font = open_font(msgFont, 14);
     velxTexture->texture =
             make_shared<TextTexture>("Horizontal speed: -000.000", font,
                                      fontColor);
 
-    auto velxPos = velxText->getComponent<PositionComponent>();
+    auto velxPos = velxText.getComponent<PositionComponent>();
     velxPos->x = m_screenWidth - m_screenWidth / 4.2f;
     velxPos->y = m_screenHeight / 10.f;
     velxPos->scallable = false;
 
     // Velocity y entity
-    auto velyText = createEntity(vely_id);
-    velyText->addComponents<TextComponent, PositionComponent>();
-    velyText->activate();
+    auto velyText = createEntity();
+    m_velY = velyText.getId();
+    velyText.addComponents<TextComponent, PositionComponent>();
+    velyText.activate();
 
-    auto velyTexture = velyText->getComponent<TextComponent>();
+    auto velyTexture = velyText.getComponent<TextComponent>();
     font = open_font(msgFont, 14);
     velyTexture->texture =
             make_shared<TextTexture>("Vertical speed: -000.000", font,
                                      fontColor);
 
-    auto velyPos = velyText->getComponent<PositionComponent>();
+    auto velyPos = velyText.getComponent<PositionComponent>();
     velyPos->x = m_screenWidth - m_screenWidth / 4.2f;
     velyPos->y = m_screenHeight / 8.f;
     velyPos->scallable = false;
 
-    auto altitude = createEntity(alt_id);
-    altitude->addComponents<TextComponent, PositionComponent>();
-    altitude->activate();
+    auto altitude = createEntity();
+    m_alt = altitude.getId();
+    altitude.addComponents<TextComponent, PositionComponent>();
+    altitude.activate();
 
-    auto altTexture = altitude->getComponent<TextComponent>();
+    auto altTexture = altitude.getComponent<TextComponent>();
     font = open_font(msgFont, 14);
     altTexture->texture = make_shared<TextTexture>("Altitude: -000.000", font,
                                                    fontColor);
 
-    auto altPos = altitude->getComponent<PositionComponent>();
+    auto altPos = altitude.getComponent<PositionComponent>();
     altPos->x = m_screenWidth - m_screenWidth / 4.2f;
     altPos->y = m_screenHeight / 7.f;
     altPos->scallable = false;
 
-    auto fuel = createEntity(fuel_id);
-    fuel->addComponents<PositionComponent, TextComponent>();
-    fuel->activate();
+    auto fuel = createEntity();
+    m_fuel = fuel.getId();
+    fuel.addComponents<PositionComponent, TextComponent>();
+    fuel.activate();
 
-    auto fuelTexture = fuel->getComponent<TextComponent>();
+    auto fuelTexture = fuel.getComponent<TextComponent>();
     font = open_font(msgFont, 14);
     fuelTexture->texture = make_shared<TextTexture>("Fuel: -000.000", font,
                                                     fontColor);
 
-    auto fuelPos = fuel->getComponent<PositionComponent>();
+    auto fuelPos = fuel.getComponent<PositionComponent>();
     fuelPos->x = m_screenWidth - m_screenWidth / 4.2f;
     fuelPos->y = m_screenHeight / 6.f;
     fuelPos->scallable = false;
 
-    auto time = createEntity(time_id);
-    time->addComponents<PositionComponent, TextComponent>();
-    time->activate();
+    auto time = createEntity();
+    m_time = time.getId();
+    time.addComponents<PositionComponent, TextComponent>();
+    time.activate();
 
-    auto timeTexture = time->getComponent<TextComponent>();
+    auto timeTexture = time.getComponent<TextComponent>();
     font = open_font(msgFont, 14);
     timeTexture->texture = make_shared<TextTexture>("Time: -000.000", font,
                                                     fontColor);
 
-    auto timePos = time->getComponent<PositionComponent>();
+    auto timePos = time.getComponent<PositionComponent>();
     timePos->x = m_screenWidth / 15.f;
     timePos->y = m_screenHeight / 15.f;
     timePos->scallable = false;
@@ -538,29 +662,69 @@ void World::init_text()
 
 void World::init_level()
 {
-    auto levelEnt = createEntity(level_id);
-    levelEnt->addComponents<LevelComponent, CollisionComponent>();
-    levelEnt->activate();
-
-    auto levelComponent = levelEnt->getComponent<LevelComponent>();
-    level.extendToRight(m_camera);
-    level.extendToLeft(m_camera);
-    levelComponent->points = level.points;
-    levelComponent->stars = level.stars;
-    levelComponent->platforms = level.platforms;
+    auto levelEnt = createEntity();
+    m_level = levelEnt.getId();
+    levelEnt.addComponents<LevelComponent, CollisionComponent>();
+    levelEnt.activate();
+
+    // Ship starts at the middle of screen, other landers right of it
+    load_level(m_screenWidth / 2.f, m_screenWidth / 2.f
+                                    + lander_spacing * (m_landerCount - 1));
+}
+
+void World::init_particles()
+{
+    auto debris = createEntity();
+    m_shipParticle = debris.getId();
+
+    utils::Rect shipClip{0, 32, SHIP_WIDTH, SHIP_HEIGHT};
+    ParticleEngine::createPool<4 * 4>(
+            debris, utils::getResourcePath("lunar_lander_bw.png"),
+            generate_clips<4, 4>(shipClip), debris_pool_size, debris_life_time);
+
+    // Exhaust particles look like pieces of flame of ship sprite
+    auto exhaust = createEntity();
+    m_exhaust = exhaust.getId();
+
+    const auto flame = utils::generate_clips<4, 4>({20, 32, SHIP_WIDTH, SHIP_HEIGHT});
+    ParticleEngine::createPool<2>(
+            exhaust, utils::getResourcePath("lunar_lander_bw.png"),
+            {flame[13], flame[14]}, exhaust_pool_size, exhaust_life_time);
+    exhaust.getComponent<ParticleSpriteComponent>()->terrain_collision = true;
 }
 
 void World::init_ship()
 {
-    using namespace utils::physics;
     // Ship entity
-    auto ship = createEntity(ship_id);
-    ship->addComponents<PositionComponent, SpriteComponent, VelocityComponent,
-            KeyboardComponent, AnimationComponent, CollisionComponent,
-            /*fuel*/ LifeTimeComponent>();
-    ship->activate();
+    auto ship = createEntity();
+    m_ship = ship.getId();
+    m_landers.assign(1, m_ship);
+    if (m_headless) {
+        ship.addComponents<PositionComponent, VelocityComponent,
+                CollisionComponent, /*fuel*/ LifeTimeComponent, LanderComponent>();
+        ship.activate();
+        init_lander(ship, m_screenWidth / 2.f);
+        ship.getComponent<LanderComponent>()->script = m_input;
+        return;
+    }
 
-    auto shipSprite = ship->getComponent<SpriteComponent>();
+    ship.addComponents<PositionComponent, SpriteComponent, VelocityComponent,
+            KeyboardComponent, AnimationComponent, CollisionComponent,
+            /*fuel*/ LifeTimeComponent, /*exhaust*/ EmitterComponent,
+            LanderComponent>();
+    ship.activate();
+    init_lander(ship, m_screenWidth / 2.f);
+
+    auto exhaust = ship.getComponent<EmitterComponent>();
+    exhaust->pool = m_exhaust;
+    exhaust->rate = exhaust_rate;
+    exhaust->speed = exhaust_speed;
+    exhaust->spread = exhaust_spread;
+    exhaust->origin_x = SHIP_WIDTH / 2.f;
+    exhaust->origin_y = SHIP_WIDTH / 2.f;
+    exhaust->nozzle = SHIP_HEIGHT / 2.f;
+
+    auto shipSprite = ship.getComponent<SpriteComponent>();
     shipSprite->sprite = make_shared<Sprite>(
             utils::getResourcePath("lunar_lander_bw.png"));
     shipSprite->sprite->addClipSprite({0, 32, SHIP_WIDTH, SHIP_HEIGHT});
@@ -568,76 +732,74 @@ void World::init_ship()
     shipSprite->sprite->addClipSprite({40, 32, SHIP_WIDTH, SHIP_HEIGHT});
     shipSprite->sprite->generateDataBuffer();
 
-    auto shipPos = ship->getComponent<PositionComponent>();
-    shipPos->x = m_screenWidth / 2.f;
-    GLfloat alt = utils::physics::altitude(
-            m_entities[level_id]->getComponent<LevelComponent>()->points,
-            shipPos->x, ship_init_alt);
-    shipPos->y = alt;
-    shipPos->angle = pi<GLfloat>() / 2.f;
-
-    auto fuel = ship->getComponent<LifeTimeComponent>();
-    fuel->time = 1500;
-
-    auto shipVel = ship->getComponent<VelocityComponent>();
-    shipVel->x = 2.f;
-    auto shipAnim = ship->getComponent<AnimationComponent>();
-
-    auto keyboardComponent = ship->getComponent<KeyboardComponent>();
-    keyboardComponent->event_handler = [shipVel, shipPos, shipAnim, fuel, this]
-            (const Uint8 *state) {
-        if (state[SDL_SCANCODE_UP] && fuel->time > 0) {
-            shipVel->y += -engine_force / weight *
-                          sin(shipPos->angle + half_pi<GLfloat>());
-            shipVel->x += -engine_force / weight *
-                          cos(shipPos->angle + half_pi<GLfloat>());
-            shipAnim->cur_state = (SDL_GetTicks() / 100) % 2 + 1;
+    // Components are fetched on each call because archetype
+    // storage may relocate them
+    auto keyboardComponent = ship.getComponent<KeyboardComponent>();
+    keyboardComponent->event_handler = [ship, this](const Uint8 *state, size_t delta) {
+        auto shipAnim = ship.getComponent<AnimationComponent>();
+        const bool thrust = LanderSystem::steer(
+                {static_cast<bool>(state[SDL_SCANCODE_UP]),
+                 static_cast<bool>(state[SDL_SCANCODE_LEFT]),
+                 static_cast<bool>(state[SDL_SCANCODE_RIGHT])},
+                *ship.getComponent<PositionComponent>(),
+                *ship.getComponent<VelocityComponent>(),
+                *ship.getComponent<LifeTimeComponent>(),
+                utils::physics::step_scale(delta));
+        ship.getComponent<EmitterComponent>()->active = thrust;
+
+        GLuint animState = 0;
+        if (thrust) {
+            animState = (SDL_GetTicks() / 100) % 2 + 1;
             if (!m_audio.isChannelPlaying(engine_channel)
                 || m_audio.isChannelPaused(engine_channel))
                 m_audio.playChunk(engine_channel, engine_idx, -1, true);
-            fuel->time -= 1;
         } else {
-            shipAnim->cur_state = 0;
             m_audio.haltChannel(engine_channel, true);
         }
 
-        if (state[SDL_SCANCODE_LEFT])
-            shipVel->angle -= rot_step;
-
-        if (state[SDL_SCANCODE_RIGHT])
-            shipVel->angle += rot_step;
+        // AnimationSystem handles only changed states
+        if (shipAnim->cur_state != animState) {
+            shipAnim->cur_state = animState;
+            ship.markChanged<AnimationComponent>();
+        }
     };
 }
 
-void World::update_movables()
+void World::init_landers()
 {
-    for (const auto& [_, en]: m_nonStatic) {
-        auto pos = en->getComponent<PositionComponent>();
-        if (pos) {
-            pos->x -= m_camera.deltaX();
-            pos->y -= m_camera.deltaY();
-        } else {
-            auto levelComp = en->getComponent<LevelComponent>();
-            for (auto& point : levelComp->points) {
-                point.x -= m_camera.deltaX();
-                point.y -= m_camera.deltaY();
-            }
-            for (auto& star : levelComp->stars) {
-                star.x -= m_camera.deltaX();
-                star.y -= m_camera.deltaY();
-            }
-            for (auto& platform: levelComp->platforms) {
-                platform.x -= m_camera.deltaX();
-                platform.y -= m_camera.deltaY();
-            }
-        }
+    // Landers beside ship have no sprites, they exist only in
+    // headless world
+    for (size_t i = 1; i < m_landerCount; ++i) {
+        auto lander = createEntity();
+        m_landers.push_back(lander.getId());
+        lander.addComponents<PositionComponent, VelocityComponent,
+                CollisionComponent, /*fuel*/ LifeTimeComponent, LanderComponent>();
+        lander.activate();
+        init_lander(lander, m_screenWidth / 2.f + lander_spacing * i);
+        lander.getComponent<LanderComponent>()->script = m_input;
     }
 }
 
-void World::filter_entities()
+void World::init_lander(Entity lander, GLfloat x)
 {
-    for (auto it = m_entities.begin(); it != m_entities.end();)
-        it = !it->second->isActivate() ? m_entities.erase(it) : ++it;
+    auto landerCol = lander.getComponent<CollisionComponent>();
+    landerCol->width = SHIP_WIDTH;
+    landerCol->height = SHIP_HEIGHT;
+
+    auto landerPos = lander.getComponent<PositionComponent>();
+    landerPos->x = x;
+    GLfloat alt = getEntity(m_level).getComponent<LevelComponent>()
+            ->terrain.altitude(landerPos->x, ship_init_alt);
+    landerPos->y = alt;
+    landerCol->altitude = ship_init_alt;
+    landerCol->hint = TerrainSegment();
+    landerPos->angle = pi<GLfloat>() / 2.f;
+
+    auto fuel = lander.getComponent<LifeTimeComponent>();
+    fuel->time = 1500;
+
+    auto landerVel = lander.getComponent<VelocityComponent>();
+    landerVel->x = 2.f;
 }
 
 TTF_Font* World::open_font(const std::string& fontName, size_t fontSize)